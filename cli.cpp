@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "framebuffer_sink.h"
+#include "renderer.h"
+#ifdef RAYTRACING_DISTRIBUTED
+#include "render_coordinator.h"
+#include "render_worker.h"
+#endif
+
+namespace {
+// Far beyond the cores of a host, a larger count is a typo rather than a request.
+constexpr int32_t kMaxThreads = 1024;
+
+constexpr char kUsage[] =
+    "Usage: raytracing-cli [options]\n"
+    "  --scene <index>          Scene to render (default 0)\n"
+    "  --width <pixels>         Image width (default 800)\n"
+    "  --height <pixels>        Image height (default 800)\n"
+    "  --spp <samples>          Maximum samples per pixel (default 100)\n"
+    "  --threads <count>        Render threads (default all hardware threads)\n"
+    "  --bvh <strategy>         middle, equal-counts or sah (default sah)\n"
+    "  --time-budget <seconds>  Stop once the next pass would exceed the budget\n"
+    "  --noise-target <error>   Stop once the estimated error falls below the target\n"
+    "  --time <seconds>         Time of the animated scene (default 0)\n"
+    "  --output <path>          PNG to write (default result.png)\n"
+    "  --batch <path>           Render a job per line of the file, each line holding the options above apart from\n"
+    "                           --threads, --frames and --fps, on top of those given on the command line. The\n"
+    "                           statistics of a job are written next to its PNG.\n"
+    "  --frames <first>:<last>  Render every job as a sequence of frames, the last run of # in the output file name\n"
+    "                           replaced by the zero padded frame number, or the number appended if there is none\n"
+    "  --fps <rate>             Frames per second of the sequence, frames start at the time of the job (default 24)\n"
+#ifdef RAYTRACING_DISTRIBUTED
+    "  --coordinator <address>  Render the jobs on the workers connecting to unix:<path> or <host>:<port>, budgets\n"
+    "                           other than the samples per pixel are not supported\n"
+    "  --worker <address>       Render tiles for the coordinator at the address until it disconnects\n"
+    "  --worker-timeout <secs>  Time a worker may take for a tile before it is dropped, and the longest the\n"
+    "                           coordinator waits without any worker (default 60)\n"
+    "  --worker-tiles <count>   Leave once handed a tile after rendering this many, as if the worker died, for\n"
+    "                           testing how the coordinator recovers\n"
+#endif
+    ;
+
+struct Job {
+  rt::RendererSettings settings;
+  std::filesystem::path output{"result.png"};
+};
+
+int32_t ParseBVHSplitStrategy(std::string_view name) {
+  if (name == "middle") return rt::BVHSplitStrategy::Middle;
+  if (name == "equal-counts") return rt::BVHSplitStrategy::EqualCounts;
+  if (name == "sah") return rt::BVHSplitStrategy::SurfaceAreaHeuristic;
+  throw std::invalid_argument{std::format("Unknown BVH split strategy: {}.", name)};
+}
+
+/**
+ * @return Whether the option applies to a single job.
+ */
+bool ParseJobOption(std::string_view option, const std::string& value, Job& job) {
+  rt::RendererSettings& settings = job.settings;
+  if (option == "--scene") {
+    settings.scene_type = std::stoi(value);
+  } else if (option == "--width") {
+    settings.width = std::stoi(value);
+  } else if (option == "--height") {
+    settings.height = std::stoi(value);
+  } else if (option == "--spp") {
+    settings.samples_per_pixel = std::stoi(value);
+  } else if (option == "--bvh") {
+    settings.bvh_split_strategy = ParseBVHSplitStrategy(value);
+  } else if (option == "--time-budget") {
+    settings.budget = rt::RenderBudget::TimeBudget;
+    settings.time_budget_seconds = std::stof(value);
+  } else if (option == "--noise-target") {
+    settings.budget = rt::RenderBudget::NoiseBudget;
+    settings.noise_target = std::stof(value);
+  } else if (option == "--time") {
+    settings.time = std::stof(value);
+  } else if (option == "--output") {
+    job.output = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void ValidateJob(const Job& job) {
+  const rt::RendererSettings& settings = job.settings;
+  if (settings.width <= 0 || settings.height <= 0 || settings.samples_per_pixel <= 0) {
+    throw std::invalid_argument{"Resolution and samples per pixel must be positive."};
+  }
+  if (settings.scene_type < 0 || settings.scene_type >= static_cast<int32_t>(std::size(rt::kSceneNames))) {
+    throw std::invalid_argument{std::format("Unknown scene: {}.", settings.scene_type)};
+  }
+  // Negated, so that NaN is rejected as well.
+  if (settings.budget == rt::RenderBudget::TimeBudget && !(settings.time_budget_seconds > 0.0f)) {
+    throw std::invalid_argument{"Time budget must be positive."};
+  }
+  if (settings.budget == rt::RenderBudget::NoiseBudget && !(settings.noise_target > 0.0f)) {
+    throw std::invalid_argument{"Noise target must be positive."};
+  }
+}
+
+void PrintStatistics(const std::filesystem::path& output, const rt::RendererStatistics& statistics) {
+  std::cout << std::format("{}: {} x {}, {} ms, {:.1f} samples per pixel in {} passes, estimated error {:.4f}\n",
+                           output.string(),
+                           statistics.width,
+                           statistics.height,
+                           statistics.render_time_ms.count(),
+                           statistics.average_samples_per_pixel,
+                           statistics.passes,
+                           statistics.estimated_error);
+}
+
+/**
+ * @return Output of the frame, the last run of # in the file name replaced by the zero padded frame number, or the
+ * number appended to the file name if it has none.
+ */
+std::filesystem::path FrameOutput(const std::filesystem::path& output, int32_t frame) {
+  std::string file_name = output.filename().string();
+  const size_t end = file_name.find_last_of('#');
+  if (end == std::string::npos) {
+    file_name = std::format("{}_{:04}{}", output.stem().string(), frame, output.extension().string());
+  } else {
+    const size_t begin = file_name.find_last_not_of('#', end) + 1;  // npos + 1 wraps to 0.
+    file_name.replace(begin, end + 1 - begin, std::format("{:0{}}", frame, end + 1 - begin));
+  }
+  return std::filesystem::path{output}.replace_filename(file_name);
+}
+
+/**
+ * @return Jobs of the frames of each job, frames are a frame interval apart from the time of their job.
+ */
+std::vector<Job> ExpandFrames(const std::vector<Job>& jobs, int32_t first_frame, int32_t last_frame, float fps) {
+  std::vector<Job> frames;
+  for (const Job& job : jobs) {
+    for (int32_t frame = first_frame; frame <= last_frame; ++frame) {
+      Job& frame_job = frames.emplace_back(job);
+      frame_job.settings.time += static_cast<float>(frame) / fps;
+      frame_job.output = FrameOutput(job.output, frame);
+    }
+  }
+  return frames;
+}
+
+/**
+ * @return Jobs of the lines of the file, blank lines and lines starting with # are skipped.
+ */
+std::vector<Job> ParseBatch(const std::filesystem::path& path, const Job& defaults) {
+  std::ifstream file{path};
+  if (!file) throw std::invalid_argument{std::format("Failed to open batch: {}.", path.string())};
+  std::vector<Job> jobs;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream tokens{line};
+    std::string option, value;
+    if (!(tokens >> option) || option.starts_with('#')) continue;
+    Job job = defaults;
+    do {
+      if (!(tokens >> value)) throw std::invalid_argument{std::format("Missing value for {}.", option)};
+      if (!ParseJobOption(option, value, job)) {
+        throw std::invalid_argument{std::format("Unknown batch option: {}.", option)};
+      }
+    } while (tokens >> option);
+    ValidateJob(job);
+    jobs.push_back(job);
+  }
+  return jobs;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Job defaults;
+  defaults.settings.width = 800;
+  defaults.settings.height = 800;
+  uint32_t thread_count = std::max(1U, std::thread::hardware_concurrency());
+  std::filesystem::path batch;
+  std::string frames;
+  float fps = 24.0f;
+  std::string coordinator_address, worker_address;
+  float worker_timeout_seconds = 60.0f;
+  int32_t worker_tile_limit = -1;
+  std::vector<Job> jobs;
+
+  try {
+    for (int32_t i = 1; i < argc; ++i) {
+      const std::string_view option{argv[i]};
+      if (option == "--help") {
+        std::cout << kUsage;
+        return EXIT_SUCCESS;
+      }
+      if (i + 1 >= argc) throw std::invalid_argument{std::format("Missing value for {}.", option)};
+      const std::string value{argv[++i]};
+      if (option == "--threads") {
+        const int32_t threads = std::stoi(value);
+        if (threads <= 0 || threads > kMaxThreads) {
+          throw std::invalid_argument{std::format("Threads must be between 1 and {}.", kMaxThreads)};
+        }
+        thread_count = static_cast<uint32_t>(threads);
+      } else if (option == "--batch") {
+        batch = value;
+      } else if (option == "--frames") {
+        frames = value;
+      } else if (option == "--fps") {
+        fps = std::stof(value);
+#ifdef RAYTRACING_DISTRIBUTED
+      } else if (option == "--coordinator") {
+        coordinator_address = value;
+      } else if (option == "--worker") {
+        worker_address = value;
+      } else if (option == "--worker-timeout") {
+        worker_timeout_seconds = std::stof(value);
+        if (!(worker_timeout_seconds > 0.0f)) throw std::invalid_argument{"Worker timeout must be positive."};
+      } else if (option == "--worker-tiles") {
+        worker_tile_limit = std::stoi(value);
+        if (worker_tile_limit < 0) throw std::invalid_argument{"Worker tiles must not be negative."};
+#endif
+      } else if (!ParseJobOption(option, value, defaults)) {
+        throw std::invalid_argument{std::format("Unknown option: {}.", option)};
+      }
+    }
+    if (batch.empty()) {
+      ValidateJob(defaults);
+      jobs.push_back(defaults);
+    } else {
+      jobs = ParseBatch(batch, defaults);
+    }
+    if (!frames.empty()) {
+      const size_t separator = frames.find(':');
+      if (separator == std::string::npos) throw std::invalid_argument{"Frames must be given as <first>:<last>."};
+      const int32_t first_frame = std::stoi(frames.substr(0, separator));
+      const int32_t last_frame = std::stoi(frames.substr(separator + 1));
+      if (first_frame < 0 || last_frame < first_frame || fps <= 0.0f) {
+        throw std::invalid_argument{"Frames must be ascending from 0 and the frame rate positive."};
+      }
+      jobs = ExpandFrames(jobs, first_frame, last_frame, fps);
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << '\n' << kUsage;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<rt::RenderJob> render_jobs;
+  for (const Job& job : jobs) {
+    rt::RenderJob& render_job = render_jobs.emplace_back(rt::RenderJob{job.settings, {}});
+    render_job.sinks.push_back(rt::MakePNGSink(job.output, job.settings.width, job.settings.height));
+    if (!batch.empty()) {
+      render_job.sinks.push_back(rt::MakeStatisticsSink(std::filesystem::path{job.output}.replace_extension(".txt")));
+    }
+    render_job.sinks.push_back({
+        .on_finish = [output = job.output](const rt::RendererStatistics& statistics) {
+          PrintStatistics(output, statistics);
+        },
+    });
+  }
+
+#ifdef RAYTRACING_DISTRIBUTED
+  try {
+    if (!worker_address.empty()) {
+      rt::RenderWorker{worker_address, thread_count}.Run(std::chrono::seconds{30}, worker_tile_limit);
+      return EXIT_SUCCESS;
+    }
+    if (!coordinator_address.empty()) {
+      const std::chrono::duration<float> worker_timeout{worker_timeout_seconds};
+      rt::RenderCoordinator coordinator{coordinator_address,
+                                        std::chrono::duration_cast<std::chrono::milliseconds>(worker_timeout)};
+      for (const rt::RenderJob& render_job : render_jobs) coordinator.Render(render_job);
+      return EXIT_SUCCESS;
+    }
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << '\n';
+    return EXIT_FAILURE;
+  }
+#endif
+
+  rt::Renderer renderer{thread_count};
+  renderer.Render(std::move(render_jobs));
+  try {
+    renderer.Wait();
+  } catch (const std::exception& exception) {
+    std::cerr << exception.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
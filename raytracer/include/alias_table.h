@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace rt {
+/**
+ * Walker's alias method for sampling a discrete distribution in constant time, built using Vose's algorithm.
+ */
+class AliasTable {
+ public:
+  AliasTable() = default;
+  explicit AliasTable(const std::vector<float>& weights);
+
+  /**
+   * @param u Uniform random number in [0, 1)
+   * @param pmf Probability of the sampled index
+   * @return Sampled index
+   */
+  uint32_t Sample(float u, float& pmf) const;
+
+  [[nodiscard]] float PMF(uint32_t index) const;
+
+  [[nodiscard]] uint32_t Size() const;
+
+ private:
+  struct Bin {
+    float probability = 0.0f;
+    uint32_t alias = 0;
+    float pmf = 0.0f;
+  };
+  std::vector<Bin> bins_;
+};
+}  // namespace rt
@@ -21,9 +21,15 @@ class Box : public Collidable<Box> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
  private:
   glm::vec3 min_point_;
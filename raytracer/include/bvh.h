@@ -26,13 +26,21 @@ enum BVHSplitStrategy { Middle, EqualCounts, SurfaceAreaHeuristic, SplitStrategy
 
 class BVH {
  public:
-  BVH(BVHSplitStrategy split_strategy, collidable_container_t& primitives, float time0, float time1);
+  BVH(BVHSplitStrategy split_strategy, const collidable_pool_t& collidables, float time0, float time1);
 
   bool Collide(const Ray& ray, float t_min, float t_max, Collision& collision) const;
 
+  /**
+   * Recomputes the bounding boxes after collidables moved, keeping the hierarchy. Much cheaper than a rebuild, though
+   * traversal slows down the further they move from where the hierarchy was built.
+   */
+  void Refit();
+
  private:
   BVHSplitStrategy split_strategy_;
-  collidable_container_t& primitives_;
+  const collidable_pool_t& collidables_;
+  // Leaves refer to a range of primitives, sorted by type within each leaf.
+  std::vector<CollidableReference> primitives_;
   float time0_, time1_;
 
   struct BVHNode {
@@ -50,12 +58,18 @@ class BVH {
   static constexpr float kTraversalCost = 0.125f;  // 1/8
   static constexpr float kIntersectionCost = 1.0f;
 
+  [[nodiscard]] AABB PrimitiveBoundingBox(CollidableReference primitive) const;
+
   [[nodiscard]] float ComputeSurfaceAreaHeuristic(const BVHNode& node, int32_t split_axis, float split_position) const;
 
   void ComputeNodeAABB(BVHNode& node);
 
   void Partition(BVHNode& node);
 
+  void SortLeavesByType();
+
+  bool CollideLeaf(const BVHNode& node, const Ray& ray, float t_min, float t_max, Collision& collision) const;
+
   bool TraverseRecursive(const BVHNode& node, const Ray& ray, float t_min, float t_max, Collision& collision) const;
 };
 }  // namespace rt
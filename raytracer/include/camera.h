@@ -3,6 +3,7 @@
 #include "glm/glm.hpp"
 
 #include "ray.h"
+#include "sampler.h"
 
 namespace rt {
 class Camera {
@@ -17,9 +18,15 @@ class Camera {
          float time0 = 0.0f,
          float time1 = 1.0f);
 
-  [[nodiscard]] Ray ShootRay(const glm::vec2& coordinate) const;
+  [[nodiscard]] Ray ShootRay(const glm::vec2& coordinate, Sampler& sampler) const;
+
+  /**
+   * Widens or narrows the viewport, keeping its height and center.
+   */
+  void SetAspectRatio(float aspect_ratio);
 
  private:
+  float aspect_ratio_;
   glm::vec3 origin_;
   glm::vec3 lower_left_corner_;
   glm::vec3 horizontal_;
@@ -6,7 +6,9 @@
 #include "aabb.h"
 #include "collision.h"
 #include "crtp.h"
+#include "direction_cone.h"
 #include "ray.h"
+#include "sampler.h"
 
 namespace rt {
 template<class T>
@@ -24,12 +26,27 @@ class Collidable : public CRTP<Collidable<T>> {
     return this->Actual().Centroid();
   }
 
+  [[nodiscard]] float Area() const {
+    return this->Actual().Area();
+  }
+
+  [[nodiscard]] const material_t* GetMaterial() const {
+    return this->Actual().GetMaterial();
+  }
+
+  /**
+   * @return Bounds of the outward surface normals, i.e. the directions the collidable may emit towards.
+   */
+  [[nodiscard]] DirectionCone NormalBounds() const {
+    return this->Actual().NormalBounds();
+  }
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
     return this->Actual().PDFValue(origin, direction);
   }
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const {
-    return this->Actual().RandomTowards(origin);
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+    return this->Actual().RandomTowards(origin, sampler);
   }
 
  private:
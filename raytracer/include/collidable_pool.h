@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rt {
+/**
+ * Refers to a collidable stored in a CollidablePool by the index of its type and its index within that type's pool.
+ */
+struct CollidableReference {
+  uint32_t type = 0;
+  uint32_t index = 0;
+
+  friend bool operator==(const CollidableReference& a, const CollidableReference& b) = default;
+};
+
+/**
+ * Stores every collidable type in its own densely packed vector, instead of a single vector of variants where each
+ * element is sized for the largest alternative.
+ * @tparam Ts Collidable types
+ */
+template<class... Ts>
+class CollidablePool {
+ public:
+  static constexpr uint32_t kTypeCount = sizeof...(Ts);
+
+  template<class T>
+  static constexpr uint32_t TypeIndex() {
+    uint32_t index = 0;
+    ((std::is_same_v<T, Ts> || (++index, false)) || ...);
+    return index;
+  }
+
+  template<class T>
+  CollidableReference Add(T collidable) {
+    static_assert(TypeIndex<T>() < kTypeCount, "Type is not stored in the pool.");
+    std::vector<T>& pool = Pool<T>();
+    pool.push_back(std::move(collidable));
+    return {TypeIndex<T>(), static_cast<uint32_t>(pool.size() - 1)};
+  }
+
+  template<class T>
+  [[nodiscard]] const std::vector<T>& Pool() const { return std::get<std::vector<T>>(pools_); }
+
+  template<class T>
+  [[nodiscard]] std::vector<T>& Pool() { return std::get<std::vector<T>>(pools_); }
+
+  [[nodiscard]] uint32_t Size() const {
+    return std::apply([](const auto& ... pools) { return (static_cast<uint32_t>(pools.size()) + ... + 0U); }, pools_);
+  }
+
+  /**
+   * @return References to every stored collidable, grouped by type.
+   */
+  [[nodiscard]] std::vector<CollidableReference> References() const {
+    std::vector<CollidableReference> references;
+    references.reserve(Size());
+    uint32_t type = 0;
+    ForEachPool([&](const auto& pool) {
+      for (uint32_t index = 0; index < static_cast<uint32_t>(pool.size()); ++index) {
+        references.push_back({type, index});
+      }
+      ++type;
+    });
+    return references;
+  }
+
+  /**
+   * Invokes the visitor with the referenced collidable.
+   */
+  template<class Visitor>
+  decltype(auto) Visit(CollidableReference reference, Visitor&& visitor) const {
+    using Result = std::invoke_result_t<Visitor, const std::tuple_element_t<0, std::tuple<Ts...>>&>;
+    using Thunk = Result (*)(const CollidablePool&, uint32_t, Visitor&);
+    static constexpr Thunk kThunks[] = {
+        [](const CollidablePool& collidables, uint32_t index, Visitor& visitor) -> Result {
+          return visitor(collidables.template Pool<Ts>()[index]);
+        }...};
+    return kThunks[reference.type](*this, reference.index, visitor);
+  }
+
+  /**
+   * Invokes the visitor with the whole pool (a const std::vector<T>&) of the given type.
+   */
+  template<class Visitor>
+  decltype(auto) VisitPool(uint32_t type, Visitor&& visitor) const {
+    using Result = std::invoke_result_t<Visitor, const std::vector<std::tuple_element_t<0, std::tuple<Ts...>>>&>;
+    using Thunk = Result (*)(const CollidablePool&, Visitor&);
+    static constexpr Thunk kThunks[] = {
+        [](const CollidablePool& collidables, Visitor& visitor) -> Result {
+          return visitor(collidables.template Pool<Ts>());
+        }...};
+    return kThunks[type](*this, visitor);
+  }
+
+  template<class Visitor>
+  void ForEachPool(Visitor&& visitor) const {
+    std::apply([&](const auto& ... pools) { (visitor(pools), ...); }, pools_);
+  }
+
+ private:
+  std::tuple<std::vector<Ts>...> pools_;
+};
+}  // namespace rt
@@ -2,6 +2,7 @@
 
 #include <variant>
 
+#include "collidable_pool.h"
 #include "transformables.h"
 #include "transform.h"
 
@@ -15,5 +16,13 @@ using collidable_t = std::variant<Box,
                                   RectangleYZ,
                                   Transform,
                                   Sphere>;
-using collidable_container_t = std::vector<collidable_t>;
+using collidable_pool_t = CollidablePool<Box,
+                                         ConstantMedium,
+                                         Flip,
+                                         MovingSphere,
+                                         RectangleXY,
+                                         RectangleXZ,
+                                         RectangleYZ,
+                                         Transform,
+                                         Sphere>;
 }  // namespace rt
@@ -20,9 +20,15 @@ class ConstantMedium : public Collidable<ConstantMedium> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
  private:
   primitive_t boundary_;
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+namespace rt {
+/**
+ * Cone of directions around an axis, used for bounding the surface normals of collidables.
+ */
+struct DirectionCone {
+  glm::vec3 axis{0.0f, 0.0f, 1.0f};
+  // Cosine of the cone's half-angle, -1 covers every direction.
+  float cos_theta = -1.0f;
+
+  [[nodiscard]] bool IsEntire() const { return cos_theta <= -1.0f; }
+
+  static DirectionCone Entire();
+
+  static DirectionCone Union(const DirectionCone& a, const DirectionCone& b);
+};
+}  // namespace rt
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "tile.h"
+
+namespace rt {
+/**
+ * RGBA pixels written by the render threads and read by a display, double buffered in blocks. Finished tiles are
+ * published into the back buffer and mark the blocks they cover as ready, the display copies only those blocks into
+ * the front buffer, which no render thread touches.
+ */
+class Framebuffer {
+ public:
+  static constexpr int32_t kBlockSize = 32;
+
+  Framebuffer() = default;
+
+  Framebuffer(const Framebuffer& framebuffer) = delete;
+  Framebuffer& operator=(const Framebuffer& framebuffer) = delete;
+
+  /**
+   * Clears both buffers, must not be called while tiles are published.
+   */
+  void Resize(int32_t width, int32_t height);
+
+  /**
+   * @param pixels Pixels of the tile, row by row
+   */
+  void Publish(const Tile& tile, const uint32_t* pixels);
+
+  /**
+   * Copies the blocks published since the last call into the front buffer.
+   * @return Regions of the front buffer that changed
+   */
+  std::vector<Tile> Flip();
+
+  [[nodiscard]] inline const uint32_t* Front() const { return front_.data(); }
+  [[nodiscard]] inline int32_t Width() const { return width_; };
+  [[nodiscard]] inline int32_t Height() const { return height_; };
+  [[nodiscard]] inline float AspectRatio() const { return static_cast<float>(width_) / static_cast<float>(height_); };
+
+ private:
+  struct alignas(64) Block {
+    std::mutex mutex;
+    std::atomic<bool> ready{false};
+  };
+
+  int32_t width_ = 0, height_ = 0;
+  int32_t horizontal_blocks_ = 0;
+  std::vector<uint32_t> back_, front_;
+  std::vector<Block> blocks_;
+
+  [[nodiscard]] Tile BlockTile(int32_t block_row, int32_t block_column) const;
+};
+}  // namespace rt
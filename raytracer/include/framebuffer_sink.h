@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+#include "framebuffer.h"
+#include "tile.h"
+
+namespace rt {
+struct RendererStatistics;
+
+/**
+ * Consumer of the pixels of a render. Callbacks left empty are skipped.
+ */
+struct FramebufferSink {
+  // Called from the render threads with the pixels of each finished tile, row by row.
+  std::function<void(const Tile& tile, const uint32_t* pixels)> on_tile;
+  // Called after every pass.
+  std::function<void(const RendererStatistics& statistics)> on_pass;
+  // Called once the render has stopped, finished or not. In a batch it runs while the next job renders.
+  std::function<void(const RendererStatistics& statistics)> on_finish;
+};
+
+/**
+ * @return Sink publishing the tiles into the framebuffer, which has to outlive the render.
+ */
+FramebufferSink MakeFramebufferSink(Framebuffer& framebuffer);
+
+/**
+ * @return Sink gathering the tiles and writing them to a PNG once the render has stopped, creating its directory.
+ * Throws from on_finish if the PNG cannot be written.
+ */
+FramebufferSink MakePNGSink(const std::filesystem::path& path, int32_t width, int32_t height);
+
+/**
+ * @return Sink writing the statistics of the render as text once it has stopped.
+ */
+FramebufferSink MakeStatisticsSink(const std::filesystem::path& path);
+}  // namespace rt
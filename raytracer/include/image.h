@@ -5,28 +5,40 @@
 
 #include "glad/glad.h"
 
+#include "framebuffer.h"
+
 namespace rt {
+/**
+ * Texture displaying the front buffer of a framebuffer.
+ */
 class Image {
  public:
-  Image(int32_t width, int32_t height, uint32_t* data);
+  explicit Image(Framebuffer& framebuffer);
 
   Image(const Image& preview) = delete;
   Image& operator=(const Image& preview) = delete;
 
+  /**
+   * Flips the framebuffer and uploads the regions that changed.
+   */
   void Update() const;
 
   [[nodiscard]] inline intptr_t Texture() const { return texture_; };
 
-  [[nodiscard]] inline uint32_t* Buffer() const { return data_; }
-  [[nodiscard]] inline int32_t Width() const { return width_; };
-  [[nodiscard]] inline int32_t Height() const { return height_; };
-  [[nodiscard]] inline float AspectRatio() const { return static_cast<float>(width_) / static_cast<float>(height_); };
+  [[nodiscard]] inline const uint32_t* Buffer() const { return framebuffer_->Front(); }
+  [[nodiscard]] inline int32_t Width() const { return framebuffer_->Width(); };
+  [[nodiscard]] inline int32_t Height() const { return framebuffer_->Height(); };
+  [[nodiscard]] inline float AspectRatio() const { return framebuffer_->AspectRatio(); };
 
-  void Resize(int32_t width, int32_t height, uint32_t* data);
+  /**
+   * Reallocates the texture after the framebuffer was resized.
+   */
+  void Resize();
 
  private:
-  int32_t width_ = 0, height_ = 0;
-  GLuint buffer_ = 0, texture_ = 0;
-  uint32_t* data_ = nullptr;
+  Framebuffer* framebuffer_;
+  GLuint texture_ = 0;
+
+  void Upload(const std::vector<Tile>& regions) const;
 };
 }  // namespace rt
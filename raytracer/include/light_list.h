@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "alias_table.h"
+#include "collidables.h"
+#include "light_tree.h"
+#include "sampler.h"
+
+namespace rt {
+/**
+ * Defines how a light is chosen for sampling.
+ */
+enum LightSamplingStrategy { PowerProportional, LightBVH, LightSamplingStrategyCount };
+
+/**
+ * Every collidable of a scene whose material is a DiffuseLight, selected either proportionally to its emitted power or
+ * through a light BVH estimating its contribution to the shading point.
+ * Refers to the collidables of the pool, which must not be modified while the list is in use.
+ */
+class LightList {
+ public:
+  LightList() = default;
+  explicit LightList(const collidable_pool_t& collidables);
+
+  [[nodiscard]] bool Empty() const;
+  [[nodiscard]] uint32_t Size() const;
+
+  /**
+   * @param origin Shading point
+   * @param normal Surface normal at the shading point, or zero if not on a surface
+   * @param u Uniform random number in [0, 1)
+   * @param light Selected light
+   * @param pmf Probability of selecting the light
+   * @return False if no light contributes to the shading point
+   */
+  bool Sample(const glm::vec3& origin,
+              const glm::vec3& normal,
+              float u,
+              LightSamplingStrategy strategy,
+              CollidableReference& light,
+              float& pmf) const;
+
+  /**
+   * @return Solid angle density of RandomTowards() generating the direction, i.e. the selection probability weighted
+   * sum over lights.
+   */
+  [[nodiscard]] float PDFValue(const glm::vec3& origin,
+                               const glm::vec3& normal,
+                               const glm::vec3& direction,
+                               LightSamplingStrategy strategy) const;
+
+  /**
+   * @return Direction towards a selected light, or zero if no light contributes to the shading point.
+   */
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin,
+                                        const glm::vec3& normal,
+                                        LightSamplingStrategy strategy,
+                                        Sampler& sampler) const;
+
+ private:
+  const collidable_pool_t* collidables_ = nullptr;
+  std::vector<CollidableReference> lights_;
+  AliasTable distribution_;
+  LightTree tree_;
+};
+}  // namespace rt
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "aabb.h"
+#include "collidables.h"
+#include "direction_cone.h"
+
+/**
+ * Light BVH for importance sampling many lights using the following resources as reference:
+ * - 'Importance Sampling of Many Lights with Adaptive Tree Splitting' by Alejandro Conty Estevez and Christopher Kulla
+ * - Physically Based Rendering, 4th Edition, Chapter 12.6.3, "BVH Light Sampling"
+ *      - Copyright(c) 1998-2023 Matt Pharr, Wenzel Jakob, and Greg Humphreys.
+ * This application is licensed under the MIT License.
+ * All source code from the references are under the rights of their respective owners.
+ */
+
+namespace rt {
+/**
+ * Spatial bounds, emission directions and total power of one or more lights.
+ */
+struct LightBounds {
+  AABB bounding_box;
+  DirectionCone normals;
+  // Cosine of the angle beyond the normal bounds where emission falls off, pi / 2 for diffuse emitters.
+  float cos_theta_e = 0.0f;
+  float power = 0.0f;
+
+  /**
+   * @return Conservative estimate of the contribution of the bounded lights to the point with the given surface normal.
+   * A zero normal ignores the orientation of the receiving surface.
+   */
+  [[nodiscard]] float Importance(const glm::vec3& point, const glm::vec3& normal) const;
+
+  static LightBounds Union(const LightBounds& a, const LightBounds& b);
+};
+
+class LightTree {
+ public:
+  LightTree() = default;
+  /**
+   * @param lights Emissive collidables, the returned light indices refer to this vector.
+   * @param powers Emitted power of each light.
+   */
+  LightTree(const collidable_pool_t& collidables,
+            const std::vector<CollidableReference>& lights,
+            const std::vector<float>& powers);
+
+  /**
+   * Stochastically traverses the tree choosing children proportionally to their importance to the point.
+   * @return False if no light contributes to the point.
+   */
+  bool Sample(const glm::vec3& point, const glm::vec3& normal, float u, uint32_t& light, float& pmf) const;
+
+  /**
+   * @return Probability of Sample() choosing the light at the point.
+   */
+  [[nodiscard]] float PMF(const glm::vec3& point, const glm::vec3& normal, uint32_t light) const;
+
+  /**
+   * @return Solid angle density of sampling the direction through the tree, visiting only nodes the direction hits.
+   */
+  [[nodiscard]] float PDFValue(const glm::vec3& point, const glm::vec3& normal, const glm::vec3& direction) const;
+
+ private:
+  struct LightNode {
+    LightBounds bounds;
+    // Index of the light for leaves, otherwise the index of the right child. The left child follows its parent.
+    uint32_t offset = 0;
+    bool leaf = false;
+  };
+
+  const collidable_pool_t* collidables_ = nullptr;
+  std::vector<CollidableReference> lights_;
+  std::vector<LightNode> nodes_;
+  // Path from the root to each light's leaf, bit i telling whether the right child was taken at depth i.
+  std::vector<uint64_t> trails_;
+
+  uint32_t Build(std::vector<uint32_t>::iterator begin,
+                 std::vector<uint32_t>::iterator end,
+                 const std::vector<LightBounds>& bounds,
+                 uint64_t trail,
+                 uint32_t depth);
+
+  [[nodiscard]] float LeftProbability(uint32_t node, const glm::vec3& point, const glm::vec3& normal) const;
+
+  [[nodiscard]] float LightPDFValue(uint32_t light, const glm::vec3& point, const glm::vec3& direction) const;
+};
+}  // namespace rt
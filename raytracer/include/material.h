@@ -7,6 +7,7 @@
 
 #include "crtp.h"
 #include "ray.h"
+#include "sampler.h"
 #include "texture.h"
 
 namespace rt {
@@ -16,8 +17,13 @@ struct Collision;
 template<class T>
 class Material : public CRTP<Material<T>> {
  public:
-  bool Scatter(const Ray& ray, const Collision& collision, glm::vec3& attenuation, Ray& scattered, float& pdf) const {
-    return this->Actual().Scatter(ray, collision, attenuation, scattered, pdf);
+  bool Scatter(const Ray& ray,
+               const Collision& collision,
+               glm::vec3& attenuation,
+               Ray& scattered,
+               float& pdf,
+               Sampler& sampler) const {
+    return this->Actual().Scatter(ray, collision, attenuation, scattered, pdf, sampler);
   }
 
   [[nodiscard]] float ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const {
@@ -28,6 +34,14 @@ class Material : public CRTP<Material<T>> {
     return this->Actual().Emit(ray, collision, u, v);
   }
 
+  /**
+   * @return True if the scattered direction is determined by the incoming one, so no density describes it and
+   * ScatteringPDF() is meaningless.
+   */
+  [[nodiscard]] bool IsSpecular() const {
+    return this->Actual().IsSpecular();
+  }
+
  private:
   Material() = default;
   friend T;
@@ -37,12 +51,19 @@ class Dielectric : public Material<Dielectric> {
  public:
   explicit Dielectric(float refraction_index);
 
-  bool Scatter(const Ray& ray, const Collision& collision, glm::vec3& attenuation, Ray& scattered, float& pdf) const;
+  bool Scatter(const Ray& ray,
+               const Collision& collision,
+               glm::vec3& attenuation,
+               Ray& scattered,
+               float& pdf,
+               Sampler& sampler) const;
 
   [[nodiscard]] float ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const;
 
   [[nodiscard]] glm::vec3 Emit(const Ray& ray, const Collision& collision, float u, float v, const glm::vec3& point) const;
 
+  [[nodiscard]] bool IsSpecular() const;
+
  private:
   float refraction_index_;
 
@@ -54,12 +75,24 @@ class DiffuseLight : public Material<DiffuseLight> {
   explicit DiffuseLight(glm::vec3 emit);
   explicit DiffuseLight(texture_t emit);
 
-  bool Scatter(const Ray& ray, const Collision& collision, glm::vec3& attenuation, Ray& scattered, float& pdf) const;
+  bool Scatter(const Ray& ray,
+               const Collision& collision,
+               glm::vec3& attenuation,
+               Ray& scattered,
+               float& pdf,
+               Sampler& sampler) const;
 
   [[nodiscard]] float ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const;
 
   [[nodiscard]] glm::vec3 Emit(const Ray& ray, const Collision& collision, float u, float v, const glm::vec3& point) const;
 
+  [[nodiscard]] bool IsSpecular() const;
+
+  /**
+   * @return Emitted radiance averaged over the texture's (u, v) domain.
+   */
+  [[nodiscard]] glm::vec3 AverageEmission() const;
+
  private:
   texture_t emit_;
 };
@@ -69,12 +102,19 @@ class Isotropic : public Material<Isotropic> {
   explicit Isotropic(glm::vec3 albedo);
   explicit Isotropic(texture_t albedo);
 
-  bool Scatter(const Ray& ray, const Collision& collision, glm::vec3& attenuation, Ray& scattered, float& pdf) const;
+  bool Scatter(const Ray& ray,
+               const Collision& collision,
+               glm::vec3& attenuation,
+               Ray& scattered,
+               float& pdf,
+               Sampler& sampler) const;
 
   [[nodiscard]] float ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const;
 
   [[nodiscard]] glm::vec3 Emit(const Ray& ray, const Collision& collision, float u, float v, const glm::vec3& point) const;
 
+  [[nodiscard]] bool IsSpecular() const;
+
  private:
   texture_t albedo_;
 };
@@ -83,12 +123,19 @@ class Lambertian : public Material<Lambertian> {
  public:
   explicit Lambertian(texture_t albedo);
 
-  bool Scatter(const Ray& ray, const Collision& collision, glm::vec3& attenuation, Ray& scattered, float& pdf) const;
+  bool Scatter(const Ray& ray,
+               const Collision& collision,
+               glm::vec3& attenuation,
+               Ray& scattered,
+               float& pdf,
+               Sampler& sampler) const;
 
   [[nodiscard]] float ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const;
 
   [[nodiscard]] glm::vec3 Emit(const Ray& ray, const Collision& collision, float u, float v, const glm::vec3& point) const;
 
+  [[nodiscard]] bool IsSpecular() const;
+
  private:
   texture_t albedo_;
 };
@@ -97,12 +144,19 @@ class Metal : public Material<Metal> {
  public:
   explicit Metal(glm::vec3 albedo, float fuzziness);
 
-  bool Scatter(const Ray& ray, const Collision& collision, glm::vec3& attenuation, Ray& scattered, float& pdf) const;
+  bool Scatter(const Ray& ray,
+               const Collision& collision,
+               glm::vec3& attenuation,
+               Ray& scattered,
+               float& pdf,
+               Sampler& sampler) const;
 
   [[nodiscard]] float ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const;
 
   [[nodiscard]] glm::vec3 Emit(const Ray& ray, const Collision& collision, float u, float v, const glm::vec3& point) const;
 
+  [[nodiscard]] bool IsSpecular() const;
+
  private:
   glm::vec3 albedo_{0, 0, 0};
   float fuzziness_;
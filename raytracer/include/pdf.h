@@ -1,13 +1,19 @@
 #pragma once
 
+#include <array>
+#include <cassert>
+#include <tuple>
+#include <utility>
 #include <variant>
 
 #include "glm/glm.hpp"
 
 #include "collidables.h"
+#include "collision.h"
 #include "crtp.h"
+#include "light_list.h"
 #include "onb.h"
-#include "random.h"
+#include "sampler.h"
 
 namespace rt {
 template<class T>
@@ -17,8 +23,8 @@ class PDF : public CRTP<PDF<T>> {
     return this->Actual().Value(direction);
   }
 
-  [[nodiscard]] glm::vec3 Generate() const {
-    return this->Actual().Generate();
+  [[nodiscard]] glm::vec3 Generate(Sampler& sampler) const {
+    return this->Actual().Generate(sampler);
   }
 
  private:
@@ -32,42 +38,157 @@ class CosinePDF : public PDF<CosinePDF> {
 
   [[nodiscard]] float Value(const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 Generate() const;
+  [[nodiscard]] glm::vec3 Generate(Sampler& sampler) const;
 
  private:
   ONB onb_;
 };
 
+/**
+ * Samples directions as the material of a collision scatters them, the collision must outlive the PDF.
+ */
+class MaterialPDF : public PDF<MaterialPDF> {
+ public:
+  MaterialPDF(const Ray& ray, const Collision& collision);
+
+  [[nodiscard]] float Value(const glm::vec3& direction) const;
+
+  [[nodiscard]] glm::vec3 Generate(Sampler& sampler) const;
+
+ private:
+  Ray ray_;
+  const Collision* collision_;
+};
+
+/**
+ * Samples directions towards a collidable, which is referred to and not copied, so it must outlive the PDF.
+ */
 class CollidablePDF : public PDF<CollidablePDF> {
  public:
-  CollidablePDF(collidable_t  collidable, const glm::vec3& origin);
+  CollidablePDF(const collidable_pool_t& collidables, CollidableReference collidable, const glm::vec3& origin);
 
   [[nodiscard]] float Value(const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 Generate() const;
+  [[nodiscard]] glm::vec3 Generate(Sampler& sampler) const;
 
  private:
-  const collidable_t collidable_;
+  const collidable_pool_t* collidables_;
+  CollidableReference collidable_;
   glm::vec3 origin_;
 };
 
-template<class T1, class T2>
-class MixturePDF : public PDF<MixturePDF<T1, T2>> {
+/**
+ * Samples directions towards the lights of a scene, which are referred to and not copied.
+ */
+class LightPDF : public PDF<LightPDF> {
  public:
-  MixturePDF(T1 pdf1, T2 pdf2) : pdf1_{pdf1}, pdf2_{pdf2} {}
+  LightPDF(const LightList& lights, LightSamplingStrategy strategy, const glm::vec3& origin, const glm::vec3& normal);
+
+  [[nodiscard]] float Value(const glm::vec3& direction) const;
 
+  /**
+   * @return Direction towards a light, or zero if no light contributes to the origin.
+   */
+  [[nodiscard]] glm::vec3 Generate(Sampler& sampler) const;
+
+ private:
+  const LightList* lights_;
+  LightSamplingStrategy strategy_;
+  glm::vec3 origin_;
+  glm::vec3 normal_;
+};
+
+/**
+ * Defines how multiple importance sampling weighs the samples of several techniques.
+ */
+enum MISHeuristic { BalanceHeuristic, PowerHeuristic, MISHeuristicCount };
+
+/**
+ * @param pdfs Densities of every technique for a sample, each scaled by the weight of its technique
+ * @param technique Technique which generated the sample
+ * @return Multiple importance sampling weight of the sample, the weights of all techniques sum up to one.
+ */
+template<size_t N>
+float MISWeight(MISHeuristic heuristic, const std::array<float, N>& pdfs, size_t technique) {
+  const auto raise = [heuristic](float pdf) { return heuristic == MISHeuristic::PowerHeuristic ? pdf * pdf : pdf; };
+  float sum = 0.0f;
+  for (const float pdf : pdfs) sum += raise(pdf);
+  return sum > 0.0f ? raise(pdfs[technique]) / sum : 0.0f;
+}
+
+/**
+ * Combines several techniques, each of which generates a direction with a probability proportional to its weight.
+ */
+template<class... Ts>
+class MultipleImportancePDF : public PDF<MultipleImportancePDF<Ts...>> {
+ public:
+  static constexpr size_t kTechniques = sizeof...(Ts);
+
+  MultipleImportancePDF(const std::array<float, kTechniques>& weights, MISHeuristic heuristic, Ts... pdfs)
+      : pdfs_{pdfs...}, heuristic_{heuristic} {
+    float sum = 0.0f;
+    for (const float weight : weights) sum += weight;
+    assert(sum > 0.0f);
+    for (size_t i = 0; i < kTechniques; ++i) weights_[i] = weights[i] / sum;
+  }
+
+  /**
+   * @return Density of generating the direction with any of the techniques.
+   */
   [[nodiscard]] float Value(const glm::vec3& direction) const {
-    return 0.5f * pdf1_.Value(direction) + 0.5f * pdf2_.Value(direction);
+    float value = 0.0f;
+    for (const float pdf : Values(direction)) value += pdf;
+    return value;
+  }
+
+  /**
+   * @return Density to divide a sample of the technique by, so that it is weighted by the heuristic.
+   */
+  [[nodiscard]] float Value(const glm::vec3& direction, size_t technique) const {
+    const std::array<float, kTechniques> pdfs = Values(direction);
+    const float weight = MISWeight(heuristic_, pdfs, technique);
+    return weight > 0.0f ? pdfs[technique] / weight : 0.0f;
+  }
+
+  [[nodiscard]] glm::vec3 Generate(Sampler& sampler) const {
+    size_t technique;
+    return Generate(technique, sampler);
   }
 
-  [[nodiscard]] glm::vec3 Generate() const {
-    return random::Float() < 0.5f ? pdf1_.Generate() : pdf2_.Generate();
+  /**
+   * @param technique Technique which generated the direction
+   */
+  [[nodiscard]] glm::vec3 Generate(size_t& technique, Sampler& sampler) const {
+    const float u = sampler.Get1D();
+    technique = 0;
+    float cdf = weights_[0];
+    while (technique + 1 < kTechniques && u >= cdf) cdf += weights_[++technique];
+    return Generate(technique, sampler, std::make_index_sequence<kTechniques>{});
   }
 
  private:
-  T1 pdf1_;
-  T2 pdf2_;
+  std::tuple<Ts...> pdfs_;
+  std::array<float, kTechniques> weights_{};
+  MISHeuristic heuristic_;
+
+  [[nodiscard]] std::array<float, kTechniques> Values(const glm::vec3& direction) const {
+    return std::apply([&](const auto& ... pdf) {
+      size_t i = 0;
+      return std::array<float, kTechniques>{(weights_[i++] * pdf.Value(direction))...};
+    }, pdfs_);
+  }
+
+  template<size_t... Is>
+  [[nodiscard]] glm::vec3 Generate(size_t technique, Sampler& sampler, std::index_sequence<Is...>) const {
+    glm::vec3 direction{0, 0, 0};
+    ((Is == technique && (direction = std::get<Is>(pdfs_).Generate(sampler), true)) || ...);
+    return direction;
+  }
 };
 
-using pdf_t = std::variant<CosinePDF, CollidablePDF, MixturePDF<CosinePDF, CollidablePDF>>;
+using pdf_t = std::variant<CosinePDF,
+                           MaterialPDF,
+                           CollidablePDF,
+                           LightPDF,
+                           MultipleImportancePDF<LightPDF, MaterialPDF>>;
 }  // namespace rt
@@ -5,10 +5,15 @@
 
 #include "glm/glm.hpp"
 
+#include "random.h"
+
 namespace rt {
 class Perlin {
  public:
-  Perlin();
+  /**
+   * @param seed Selects the lattice, the same seed always yields the same noise.
+   */
+  explicit Perlin(uint32_t seed = 0);
 
   [[nodiscard]] float Noise(const glm::vec3& point) const;
 
@@ -22,7 +27,7 @@ class Perlin {
   std::array<uint32_t, kPointCount> permutation_y_{};
   std::array<uint32_t, kPointCount> permutation_z_{};
 
-  static void Permute(std::array<uint32_t, kPointCount>& permutation);
+  static void Permute(std::array<uint32_t, kPointCount>& permutation, random::Generator& generator);
 
   static float Interpolation(glm::vec3 c[2][2][2], glm::vec3 uvw);
 };
@@ -5,26 +5,64 @@
 #include "glm/glm.hpp"
 
 namespace rt::random {
-uint32_t UInt32();
+/**
+ * PCG32 generator, whose 16 bytes of state are cheap enough to create for every sample and pass along the render path.
+ */
+class Generator {
+ public:
+  /**
+   * @param sequence Selects one of 2^63 independent sequences
+   * @param seed Starting point within the sequence
+   */
+  explicit Generator(uint64_t sequence, uint64_t seed = 0);
 
-uint32_t UInt32(uint32_t min, uint32_t max);
+  uint32_t UInt32();
 
-float Float();
+ private:
+  uint64_t state_ = 0;
+  uint64_t increment_;
+};
 
-float Float(float min, float max);
+/**
+ * @return Well mixed combination of both values, e.g. to key a generator by a pixel and a sample index.
+ */
+uint64_t Hash(uint64_t a, uint64_t b);
 
-glm::vec3 Vec3();
+/**
+ * @return Hash of the bit patterns of both vectors, e.g. to key a generator by a ray.
+ */
+uint64_t Hash(const glm::vec3& a, const glm::vec3& b);
 
-glm::vec3 Vec3(float min, float max);
+uint32_t UInt32(Generator& generator, uint32_t min, uint32_t max);
 
-glm::vec3 CosineDirection();
+/**
+ * @return Uniform random number in [0, 1)
+ */
+float Float(Generator& generator);
 
-glm::vec3 InUnitSphere();
+float Float(Generator& generator, float min, float max);
 
-glm::vec3 InUnitDisk();
+glm::vec3 Vec3(Generator& generator);
 
-glm::vec3 InHemisphere(const glm::vec3& normal);
+glm::vec3 Vec3(Generator& generator, float min, float max);
 
-glm::vec3 UnitVec3();
+// The following map uniform random numbers in [0, 1) to their domain, unlike rejection sampling they preserve how well
+// the numbers are distributed.
+
+glm::vec3 CosineDirection(const glm::vec2& u);
+
+glm::vec3 InUnitSphere(const glm::vec3& u);
+
+glm::vec3 InUnitDisk(const glm::vec2& u);
+
+glm::vec3 InHemisphere(const glm::vec3& u, const glm::vec3& normal);
+
+glm::vec3 UnitVec3(const glm::vec2& u);
+
+/**
+ * @return Direction, in the local frame whose z-axis points towards the sphere's center, uniformly distributed over the
+ * cone subtended by a sphere.
+ */
+glm::vec3 ToSphere(const glm::vec2& u, float radius, float distance_squared);
 
 }  // namespace rt::random
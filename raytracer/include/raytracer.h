@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "image.h"
 #include "renderer.h"
@@ -14,8 +15,13 @@ class Raytracer {
  private:
   Renderer renderer_;
   RendererSettings renderer_settings_;
+  // Textures showing the framebuffers of the renderer, created once there is a context.
+  std::unique_ptr<Image> preview_;
+  std::unique_ptr<Image> sample_count_map_;
 
   int32_t viewport_width_ = 0, viewport_height_ = 0;
+  bool show_sample_counts_ = false;
+  std::string save_error_;
 
   void RenderUI();
   void RenderUISettings();
@@ -25,9 +25,15 @@ class RectangleXY : public Collidable<RectangleXY> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
  private:
   glm::vec2 x_{0.0f, 1.0f}, y_{0.0f, 1.0f};
@@ -45,9 +51,15 @@ class RectangleXZ : public Collidable<RectangleXZ> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
  private:
   glm::vec2 x_{0.0f, 1.0f}, z_{0.0f, 1.0f};
@@ -65,9 +77,15 @@ class RectangleYZ : public Collidable<RectangleYZ> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
  private:
   glm::vec2 y_{0.0f, 1.0f}, z_{0.0f, 1.0f};
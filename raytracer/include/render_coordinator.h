@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "framebuffer.h"
+#include "render_protocol.h"
+#include "renderer.h"
+#include "socket.h"
+#include "tile.h"
+
+namespace rt {
+/**
+ * Renders across worker processes, each a RenderWorker building the scene from the settings on its own. Tiles are
+ * handed out one at a time to every connected worker and merged into the result as they come back.
+ */
+class RenderCoordinator {
+ public:
+  /**
+   * Listens for workers at the address, they may connect at any time.
+   * @param worker_timeout Time a worker may take for a tile, and the longest a render waits without any worker.
+   * Connections which do not greet within five seconds, or within the timeout if shorter, are closed.
+   * @throws std::runtime_error If the address cannot be bound.
+   */
+  explicit RenderCoordinator(const std::string& address,
+                             std::chrono::milliseconds worker_timeout = std::chrono::seconds{60},
+                             int32_t tile_size = 64);
+
+  /**
+   * Renders the job on the workers and returns once every tile is merged. Tiles of workers which disconnect or exceed
+   * the timeout are handed to the others.
+   * @throws std::invalid_argument If the job has a time or noise budget, which would only apply to each tile.
+   * @throws std::runtime_error If no worker is connected for longer than the timeout.
+   */
+  RendererStatistics Render(const RenderJob& job, std::stop_token stop_token = {});
+
+  [[nodiscard]] Framebuffer& Result();
+
+  [[nodiscard]] size_t WorkerCount() const;
+
+ private:
+  struct Worker {
+    Socket socket;
+    std::chrono::steady_clock::time_point connect_time;
+    bool greeted = false;
+    bool has_settings = false;
+    std::optional<Tile> tile;
+    std::chrono::steady_clock::time_point tile_start_time;
+    // Bytes of the message being received, its header followed by as much of the payload as has arrived.
+    std::vector<uint8_t> message;
+  };
+
+  /**
+   * Tiles and totals of the render in progress.
+   */
+  struct Progress {
+    const RenderJob& job;
+    std::deque<Tile> pending_tiles;
+    size_t remaining_tiles = 0;
+    RendererStatistics statistics;
+    uint64_t samples = 0;
+    double squared_error = 0.0;
+  };
+
+  Socket listener_;
+  std::chrono::milliseconds worker_timeout_;
+  int32_t tile_size_;
+  std::vector<Worker> workers_;
+  Framebuffer framebuffer_;
+
+  /**
+   * Accepts every pending worker, which starts rendering once its greeting has arrived.
+   */
+  void AcceptWorkers();
+
+  /**
+   * Closes the connection, its tile goes back to the front of the pending ones.
+   */
+  static void DropWorker(Worker& worker, std::deque<Tile>& pending_tiles);
+
+  /**
+   * Receives what the worker has sent without blocking and handles every message completed by it.
+   * @return Whether the worker is still connected and only sent what it was asked for.
+   */
+  bool Receive(Worker& worker, Progress& progress);
+
+  /**
+   * @return Whether the worker may send a message of the type and size in its state.
+   */
+  static bool Expects(const Worker& worker, const protocol::MessageHeader& header);
+
+  /**
+   * Merges the tile the worker was handed into the result.
+   */
+  void MergeTile(Worker& worker, const protocol::TileResultMessage& result, const uint8_t* pixels, Progress& progress);
+};
+}  // namespace rt
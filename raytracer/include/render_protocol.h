@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "renderer.h"
+#include "socket.h"
+#include "tile.h"
+
+/**
+ * Messages between a coordinator and its workers. Payloads are sent as they lie in memory, so the greeting of a worker
+ * carries the byte order and a fingerprint of the layout of the payloads, which the coordinator compares with its own.
+ * That does not catch fields changing their meaning at the same size and offset, which needs a new version.
+ */
+namespace rt::protocol {
+constexpr uint32_t kVersion = 2;
+// Reads as 0x04030201 on a machine of the other byte order.
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+enum MessageType : uint32_t {
+  Hello,       // Worker to coordinator, HelloMessage.
+  Settings,    // Coordinator to worker, RendererSettings of the following tiles.
+  RenderTile,  // Coordinator to worker, Tile.
+  TileResult,  // Worker to coordinator, TileResultMessage followed by the pixels of the tile row by row.
+  MessageTypeCount
+};
+
+struct MessageHeader {
+  uint32_t type = MessageType::MessageTypeCount;
+  uint32_t size = 0;
+};
+
+struct TileResultMessage {
+  Tile tile;
+  int32_t passes = 0;
+  uint64_t samples = 0;
+  // Sum of the squared errors of the pixels.
+  double squared_error = 0.0;
+};
+
+/**
+ * FNV-1a over the sizes and offsets of the payload fields and the number of values of the enums among them.
+ */
+constexpr uint64_t LayoutFingerprint() {
+  constexpr size_t kLayout[] = {
+      sizeof(MessageHeader), MessageTypeCount,
+      sizeof(Tile), offsetof(Tile, rows), offsetof(Tile, columns),
+      sizeof(RendererSettings),
+      offsetof(RendererSettings, width), offsetof(RendererSettings, height),
+      offsetof(RendererSettings, region),
+      offsetof(RendererSettings, scene_type),
+      offsetof(RendererSettings, time),
+      offsetof(RendererSettings, mode),
+      offsetof(RendererSettings, chunk_size),
+      offsetof(RendererSettings, balance_chunk_costs),
+      offsetof(RendererSettings, samples_per_pixel),
+      offsetof(RendererSettings, samples_per_pass),
+      offsetof(RendererSettings, budget), RenderBudgetCount,
+      offsetof(RendererSettings, time_budget_seconds),
+      offsetof(RendererSettings, noise_target),
+      offsetof(RendererSettings, adaptive_sampling),
+      offsetof(RendererSettings, adaptive_min_samples),
+      offsetof(RendererSettings, adaptive_error_threshold),
+      offsetof(RendererSettings, max_child_rays),
+      offsetof(RendererSettings, russian_roulette),
+      offsetof(RendererSettings, russian_roulette_depth),
+      offsetof(RendererSettings, bvh_split_strategy), SplitStrategyCount,
+      offsetof(RendererSettings, sampler_type), SamplerTypeCount,
+      offsetof(RendererSettings, light_sampling_strategy), LightSamplingStrategyCount,
+      offsetof(RendererSettings, next_event_estimation),
+      offsetof(RendererSettings, mis_heuristic), MISHeuristicCount,
+      offsetof(RendererSettings, light_sampling_weight),
+      sizeof(TileResultMessage),
+      offsetof(TileResultMessage, tile),
+      offsetof(TileResultMessage, passes),
+      offsetof(TileResultMessage, samples),
+      offsetof(TileResultMessage, squared_error),
+  };
+  uint64_t hash = 14695981039346656037ull;
+  for (const uint64_t value : kLayout) {
+    for (size_t byte = 0; byte < sizeof(value); ++byte) {
+      hash = (hash ^ ((value >> (byte * 8)) & 0xff)) * 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+struct HelloMessage {
+  uint32_t byte_order = kByteOrderMark;
+  uint32_t version = kVersion;
+  uint64_t layout = LayoutFingerprint();
+
+  /**
+   * @return Whether the worker sends and reads payloads as this build does.
+   */
+  [[nodiscard]] inline bool Compatible() const {
+    return byte_order == kByteOrderMark && version == kVersion && layout == LayoutFingerprint();
+  }
+};
+
+static_assert(std::is_trivially_copyable_v<RendererSettings>);
+
+/**
+ * Sends the payload, followed by the extra bytes if any.
+ * @return Whether the message was sent, false once the peer is gone.
+ */
+template<class Payload>
+bool SendMessage(const Socket& socket,
+                 MessageType type,
+                 const Payload& payload,
+                 const void* extra = nullptr,
+                 uint32_t extra_size = 0) {
+  static_assert(std::is_trivially_copyable_v<Payload>);
+  const MessageHeader header{type, static_cast<uint32_t>(sizeof(Payload)) + extra_size};
+  return socket.Send(&header, sizeof(header)) && socket.Send(&payload, sizeof(Payload))
+      && (extra_size == 0 || socket.Send(extra, extra_size));
+}
+
+/**
+ * Receives the payload of a message whose header was received, leaving the extra bytes to the caller.
+ * @return Whether the header announced the payload with that many extra bytes and the payload was received.
+ */
+template<class Payload>
+bool ReceivePayload(const Socket& socket, const MessageHeader& header, Payload& payload, uint32_t extra_size = 0) {
+  static_assert(std::is_trivially_copyable_v<Payload>);
+  return header.size == sizeof(Payload) + extra_size && socket.Receive(&payload, sizeof(Payload));
+}
+}  // namespace rt::protocol
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "renderer.h"
+#include "socket.h"
+#include "tile.h"
+
+namespace rt {
+/**
+ * Renders the tiles a RenderCoordinator hands out, building and reusing the scenes of its settings on its own.
+ */
+class RenderWorker {
+ public:
+  RenderWorker(std::string address, uint32_t thread_count);
+
+  /**
+   * Connects to the coordinator, retrying until it listens, and renders its tiles until it disconnects.
+   * @param tile_limit Tiles to render before disconnecting once handed the next one, as if the worker died while
+   * rendering it. Unlimited when negative.
+   * @throws std::runtime_error If the coordinator cannot be reached within the timeout or sends an unknown message.
+   */
+  void Run(std::chrono::milliseconds connect_timeout = std::chrono::seconds{30}, int32_t tile_limit = -1);
+
+ private:
+  std::string address_;
+  Renderer renderer_;
+  RendererSettings settings_;
+
+  [[nodiscard]] Socket Connect(std::chrono::milliseconds timeout) const;
+
+  /**
+   * @return Whether the tile was rendered and sent.
+   */
+  bool RenderTile(const Socket& socket, const Tile& tile);
+};
+}  // namespace rt
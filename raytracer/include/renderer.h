@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <exception>
+#include <future>
 #include <memory>
+#include <stop_token>
 #include <thread>
 #include <vector>
 
@@ -10,26 +14,81 @@
 #include "glm/glm.hpp"
 
 #include "bvh.h"
-#include "image.h"
+#include "framebuffer.h"
+#include "framebuffer_sink.h"
+#include "light_list.h"
+#include "pdf.h"
 #include "ray.h"
+#include "sampler.h"
 #include "scene.h"
+#include "texture_registry.h"
+#include "tile.h"
+#include "tile_cost_map.h"
+#include "tile_scheduler.h"
 
 namespace rt {
 enum RenderMode { ChunkByChunk = 0, RowByRow = 1 };
 
+/**
+ * What ends a render, besides every pixel having taken the samples per pixel or having converged.
+ */
+enum RenderBudget { SampleBudget, TimeBudget, NoiseBudget, RenderBudgetCount };
+
 struct RendererSettings {
   int32_t width = 0, height = 0;
+  // Part of the image to render, all of it when empty. Pixels outside of it are neither sampled nor published.
+  Tile region;
   int32_t scene_type = SceneType::Part3Section10;
+  // Time of the frame in seconds, scenes move their camera and collidables by it.
+  float time = 0.0f;
   int32_t mode = RenderMode::ChunkByChunk;
   int32_t chunk_size = 32;
+  // After the first pass, chunks are cut so that each took similar time in the previous pass. Their number stays the
+  // same as with the chunk size.
+  bool balance_chunk_costs = true;
   int32_t samples_per_pixel = 100;
+  // Every pixel takes this many samples before the next pass starts, the preview is updated after each.
+  int32_t samples_per_pass = 4;
+  // Passes stop once the next one is expected to exceed the time budget, or once the estimated error of the image
+  // falls below the noise target.
+  int32_t budget = RenderBudget::SampleBudget;
+  float time_budget_seconds = 30.0f;
+  float noise_target = 0.01f;
+  // Stops sampling a pixel once its error, in display units, falls below the threshold. Samples per pixel is then the
+  // maximum a pixel may take.
+  bool adaptive_sampling = true;
+  int32_t adaptive_min_samples = 16;
+  float adaptive_error_threshold = 0.005f;
   int32_t max_child_rays = 50;
+  bool russian_roulette = true;
+  int32_t russian_roulette_depth = 3;
   int32_t bvh_split_strategy = BVHSplitStrategy::SurfaceAreaHeuristic;
+  int32_t sampler_type = SamplerType::Sobol;
+  int32_t light_sampling_strategy = LightSamplingStrategy::LightBVH;
+  bool next_event_estimation = true;
+  int32_t mis_heuristic = MISHeuristic::PowerHeuristic;
+  float light_sampling_weight = 0.5f;
 };
 
 struct RendererStatistics {
   int32_t width = 0, height = 0;
   std::chrono::milliseconds render_time_ms = std::chrono::milliseconds::zero();
+  // Time spent building or updating the scene, in a batch while the previous job was rendering.
+  std::chrono::milliseconds scene_time_ms = std::chrono::milliseconds::zero();
+  TextureMemoryUsage texture_memory;
+  float average_samples_per_pixel = 0.0f;
+  int32_t passes = 0;
+  // Root mean square of the standard errors of the pixels, in display units.
+  float estimated_error = 0.0f;
+  bool cancelled = false;
+};
+
+/**
+ * Render of a batch, its sinks observe it in addition to those of the renderer.
+ */
+struct RenderJob {
+  RendererSettings settings;
+  std::vector<FramebufferSink> sinks;
 };
 
 class Renderer {
@@ -38,33 +97,168 @@ class Renderer {
 
   Renderer() = default;
 
+  explicit Renderer(uint32_t thread_count);
+
+  /**
+   * Cancels a running render and waits for it to stop.
+   */
+  ~Renderer();
+
   void OnResize(int32_t width, int32_t height);
 
+  /**
+   * Starts rendering on a thread of its own, after a previous render has stopped.
+   */
   void Render(const RendererSettings& settings);
 
-  [[nodiscard]] std::shared_ptr<Image> Result() const;
+  /**
+   * Renders the jobs one after another on a thread of its own, after a previous render has stopped. Each job resizes
+   * the result to its resolution and reuses the scenes built by the previous ones. The scene of the next job is
+   * prepared and the sinks of the previous one finish while a job renders, so a sequence of frames is best rendered as
+   * a batch.
+   */
+  void Render(std::vector<RenderJob> jobs);
+
+  /**
+   * Requests a running render or batch to stop, pixels finish the sample they are taking. Does not wait for it.
+   */
+  void Cancel();
+
+  /**
+   * Blocks until a running render has stopped.
+   * @throws std::exception First error of building a scene or of a sink, which stopped the render.
+   */
+  void Wait();
+
+  /**
+   * Adds a consumer of the pixels of the following renders, in addition to the result. Not to be called while
+   * rendering.
+   */
+  void AddSink(FramebufferSink sink);
+
+  void ClearSinks();
+
+  [[nodiscard]] Framebuffer& Result();
+
+  /**
+   * @return Number of samples each pixel took, brighter meaning more samples relative to the maximum.
+   */
+  [[nodiscard]] Framebuffer& SampleCountMap();
+
+  [[nodiscard]] const std::vector<uint32_t>& SampleCounts() const;
 
   RenderState State() const;
 
   RendererStatistics Statistics() const;
 
  private:
-  RenderState state_{RenderState::Stopped};
-  std::thread main_render_thread_;
-  BS::thread_pool pool_{std::max(1U, std::thread::hardware_concurrency() - 2)};
+  std::atomic<RenderState> state_{RenderState::Stopped};
+  std::jthread main_render_thread_;
+  // First error of the running render, rethrown by Wait().
+  std::exception_ptr error_;
+  // Stop token of the running render, checked by the pixels between samples.
+  std::stop_token stop_token_;
+  BS::thread_pool pool_{std::max(3U, std::thread::hardware_concurrency()) - 2};
+  TileScheduler scheduler_;
+  TileCostMap tile_costs_;
 
   std::shared_ptr<Scene> scene_;
-  std::shared_ptr<Image> preview_;
-  std::vector<uint32_t> image_data_;
+  // Scenes built so far, updated to the settings of each render. A type has a second one once the next job of a batch
+  // needs it updated while the first renders.
+  std::vector<std::shared_ptr<Scene>> scenes_;
+  int32_t width_ = 0, height_ = 0;
+  Framebuffer framebuffer_;
+  Framebuffer sample_count_map_;
+  std::vector<FramebufferSink> sinks_;
+  std::vector<FramebufferSink> job_sinks_;
+  std::vector<uint32_t> sample_counts_;
+
+  /**
+   * Samples of a pixel gathered over the passes so far.
+   */
+  struct PixelAccumulator {
+    glm::vec3 color{0, 0, 0};
+    // Running mean and sum of squared deviations of the luminance, after Welford.
+    float luminance_mean = 0.0f;
+    float luminance_squared_deviations = 0.0f;
+    float error = 0.0f;
+    bool converged = false;
+  };
+  std::vector<PixelAccumulator> accumulation_;
 
   RendererSettings settings_;
   RendererStatistics statistics_;
 
-  void RenderRow(int32_t row);
+  void Resize(int32_t width, int32_t height);
+
+  /**
+   * Blocks until a running render has stopped, leaving its error to Wait().
+   */
+  void Join();
+
+  struct PreparedScene {
+    std::shared_ptr<Scene> scene;
+    std::chrono::milliseconds time_ms = std::chrono::milliseconds::zero();
+  };
+
+  void RunJob(const RenderJob& job, const PreparedScene& prepared);
+
+  /**
+   * @return Region of the settings within the image, or the whole image.
+   */
+  [[nodiscard]] Tile Region() const;
+
+  /**
+   * @return Chunk size of the settings, or a smaller one if the region would otherwise leave threads without chunks.
+   */
+  [[nodiscard]] int32_t ChunkSize(const Tile& region) const;
+
+  template<class Function>
+  void ForEachSink(Function&& function) const {
+    for (const FramebufferSink& sink : sinks_) function(sink);
+    for (const FramebufferSink& sink : job_sinks_) function(sink);
+  }
+
+  /**
+   * Adds a pass of samples to every pixel which has not converged yet.
+   */
+  void RenderPass();
+
+  /**
+   * Builds the scene of the settings, or updates a previous one of the same type other than the rendering one.
+   */
+  PreparedScene PrepareScene(const RendererSettings& settings,
+                             float aspect_ratio,
+                             const std::shared_ptr<Scene>& rendering);
+
+  /**
+   * Updates the average samples per pixel and the estimated error from the pixels of the region sampled so far.
+   * @return Whether the error is estimated for every pixel still sampling, which takes two samples of it.
+   */
+  bool UpdateSampleStatistics();
+
+  /**
+   * Renders the tile into buffers of its own and publishes them to the framebuffers once it is done.
+   */
+  void RenderTile(const Tile& tile);
+
+  /**
+   * Adds a pass of samples to the accumulator of a pixel.
+   */
+  void SamplePixel(int32_t row, int32_t column, Sampler& sampler);
 
-  void RenderChuck(glm::i32vec2 rows, glm::i32vec2 columns);
+  glm::vec4 RenderPixel(const Ray& ray, int32_t child_rays, Sampler& sampler);
 
-  glm::vec4 RenderPixel(const Ray& ray, int32_t child_rays);
+  /**
+   * Samples a direction towards the lights and traces a shadow ray along it.
+   * @return Emitted radiance reaching the collision point, weighted by the scattering and sampling densities.
+   */
+  [[nodiscard]] glm::vec3 SampleLights(const Ray& ray,
+                                       const Collision& collision,
+                                       LightSamplingStrategy strategy,
+                                       const std::array<float, 2>& weights,
+                                       MISHeuristic heuristic,
+                                       Sampler& sampler) const;
 
   static glm::vec4 ColorCorrection(int32_t samples_per_pixel, const glm::vec4& color);
 };
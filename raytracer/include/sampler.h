@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "random.h"
+
+namespace rt {
+/**
+ * Defines how the samples of a pixel are distributed over each dimension.
+ */
+enum SamplerType { Independent, Stratified, Halton, Sobol, SamplerTypeCount };
+
+/**
+ * Provides the uniform random numbers of the samples of a pixel, dimension by dimension, so that the samples of a pixel
+ * cover each dimension evenly. A sample draws its dimensions in the order the render path consumes them: the camera
+ * uses the first ones, followed by the materials and lights of each bounce.
+ */
+class Sampler {
+ public:
+  Sampler(SamplerType type, int32_t samples_per_pixel);
+
+  /**
+   * Restarts at the first dimension of the sample of the pixel.
+   */
+  void StartPixelSample(const glm::i32vec2& pixel, int32_t sample);
+
+  /**
+   * @return Uniform random number in [0, 1)
+   */
+  float Get1D();
+
+  /**
+   * @return Uniform random numbers in [0, 1)^2, well distributed jointly and not only along each axis.
+   */
+  glm::vec2 Get2D();
+
+ private:
+  SamplerType type_;
+  uint32_t samples_per_pixel_;
+  uint64_t pixel_hash_ = 0;
+  uint32_t sample_ = 0;
+  uint32_t dimension_ = 0;
+  random::Generator generator_{0};
+
+  [[nodiscard]] uint64_t DimensionHash() const;
+};
+}  // namespace rt
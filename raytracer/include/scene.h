@@ -10,8 +10,10 @@
 #include "camera.h"
 #include "constant_medium.h"
 #include "flip.h"
+#include "light_list.h"
 #include "rectangle.h"
 #include "sphere.h"
+#include "texture_registry.h"
 #include "transform.h"
 
 namespace rt {
@@ -32,18 +34,49 @@ class Scene {
 
   [[nodiscard]] Camera* GetCamera() const;
   [[nodiscard]] glm::vec3 BackgroundColor() const;
-  [[nodiscard]] collidable_t* Light() const;
+  [[nodiscard]] const LightList& Lights() const;
+  [[nodiscard]] const TextureRegistry& Textures() const;
+
+  [[nodiscard]] SceneType Type() const;
+  [[nodiscard]] float AspectRatio() const;
+  [[nodiscard]] BVHSplitStrategy SplitStrategy() const;
+  [[nodiscard]] float Time() const;
+
+  /**
+   * Adjusts the camera only, the collidables and their hierarchies are kept.
+   */
+  void SetAspectRatio(float aspect_ratio);
+
+  /**
+   * Rebuilds the BVH only, the collidables, textures and lights are kept.
+   */
+  void SetSplitStrategy(BVHSplitStrategy bvh_split_strategy);
+
+  /**
+   * Moves the camera and collidables to where they are at the time, in seconds, refits the BVH and rebuilds the lights.
+   */
+  void SetTime(float time);
 
  private:
+  SceneType scene_type_;
   float aspect_ratio_ = 1.0f;
   glm::vec3 background_color_{0, 0, 0};
   BVHSplitStrategy bvh_split_strategy_ = BVHSplitStrategy::SurfaceAreaHeuristic;
+  float time_ = 0.0f;
 
   std::unique_ptr<Camera> camera_;
-  collidable_container_t collidables_;
+  TextureRegistry textures_;
+  collidable_pool_t collidables_;
   std::unique_ptr<BVH> bvh_;
-  std::unique_ptr<collidable_t> light_;
+  LightList lights_;
+  // Indices of the transforms moved by the animation of the scene.
+  std::vector<uint32_t> animated_transforms_;
+
+  void BuildBVH();
+
+  void Animate();
 
   void InitializePart3Section10();
+  void AnimatePart3Section10();
 };
 }  // namespace rt
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace rt {
+/**
+ * Stream socket over POSIX, either Unix-domain with addresses like unix:/tmp/raytracing.sock or TCP with addresses like
+ * 127.0.0.1:7000. Closed on destruction.
+ */
+class Socket {
+ public:
+  Socket() = default;
+  explicit Socket(int fd);
+  Socket(Socket&& other) noexcept;
+  Socket& operator=(Socket&& other) noexcept;
+  Socket(const Socket& other) = delete;
+  Socket& operator=(const Socket& other) = delete;
+  ~Socket();
+
+  /**
+   * @throws std::runtime_error If the address cannot be bound.
+   */
+  static Socket Listen(const std::string& address);
+
+  /**
+   * @throws std::runtime_error If nothing listens at the address.
+   */
+  static Socket Connect(const std::string& address);
+
+  /**
+   * @return Connection of a peer, invalid if none is pending. Listening sockets do not block.
+   */
+  Socket Accept() const;
+
+  /**
+   * @return Whether all bytes were sent, false once the peer is gone.
+   */
+  bool Send(const void* data, size_t size) const;
+
+  /**
+   * @return Whether all bytes were received, false once the peer is gone.
+   */
+  bool Receive(void* data, size_t size) const;
+
+  /**
+   * @return Number of bytes received without blocking, 0 if none are pending and -1 once the peer is gone.
+   */
+  ptrdiff_t ReceiveAvailable(void* data, size_t size) const;
+
+  void Close();
+
+  [[nodiscard]] inline int Fd() const { return fd_; }
+  [[nodiscard]] inline bool Valid() const { return fd_ >= 0; }
+
+ private:
+  int fd_ = -1;
+};
+}  // namespace rt
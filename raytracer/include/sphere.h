@@ -19,9 +19,15 @@ class Sphere : public Collidable<Sphere> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
  private:
   glm::vec3 center_;
@@ -41,9 +47,15 @@ class MovingSphere : public Collidable<MovingSphere> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
 
   [[nodiscard]] glm::vec3 CenterAt(float time) const;
 
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <filesystem>
+#include <cstdint>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -52,27 +53,39 @@ class CheckerTexture : public Texture<CheckerTexture> {
   SolidColorTexture odd_;
 };
 
+/**
+ * Lightweight handle to a Perlin lattice shared via TextureRegistry.
+ */
 class NoiseTexture : public Texture<NoiseTexture> {
  public:
-  NoiseTexture() = default;
-  explicit NoiseTexture(float scale);
+  NoiseTexture(std::shared_ptr<const Perlin> perlin, float scale);
 
   [[nodiscard]] glm::vec3 Sample(float u, float v, const glm::vec3& point) const;
 
  private:
-  Perlin perlin_;
+  std::shared_ptr<const Perlin> perlin_;
   float scale_ = 1.0f;
 };
 
+/**
+ * Decoded RGB pixel data of an image texture.
+ */
+struct ImageData {
+  int32_t width = 0, height = 0;
+  std::vector<uint8_t> buffer;
+};
+
+/**
+ * Lightweight handle to decoded image data shared via TextureRegistry.
+ */
 class ImageTexture : public Texture<ImageTexture> {
  public:
-  explicit ImageTexture(const std::filesystem::path& path);
+  explicit ImageTexture(std::shared_ptr<const ImageData> image);
 
   [[nodiscard]] glm::vec3 Sample(float u, float v, const glm::vec3& point) const;
 
  private:
-  int32_t width_ = 0, height_ = 0;
-  std::vector<uint8_t> buffer_;
+  std::shared_ptr<const ImageData> image_;
 };
 
 using texture_t = std::variant<SolidColorTexture, CheckerTexture, NoiseTexture, ImageTexture>;
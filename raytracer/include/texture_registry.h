@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "perlin.h"
+#include "texture.h"
+
+namespace rt {
+struct TextureMemoryUsage {
+  uint32_t image_count = 0, noise_count = 0;
+  std::size_t image_bytes = 0, noise_bytes = 0;
+
+  [[nodiscard]] std::size_t TotalBytes() const { return image_bytes + noise_bytes; }
+};
+
+/**
+ * Loads and creates the heavy texture data (decoded images, Perlin lattices) at most once and hands out lightweight
+ * texture handles sharing that data. Handles keep their data alive through reference counting, so copying a material
+ * or a texture_t never duplicates the underlying data.
+ * Not thread-safe; intended to be used while building a scene.
+ */
+class TextureRegistry {
+ public:
+  TextureRegistry() = default;
+  TextureRegistry(const TextureRegistry& registry) = delete;
+  TextureRegistry& operator=(const TextureRegistry& registry) = delete;
+
+  /**
+   * @param path Path to the image file, decoded on the first request only.
+   */
+  ImageTexture GetImage(const std::filesystem::path& path);
+
+  /**
+   * @param scale Noise frequency, does not affect the shared lattice.
+   * @param lattice Identifier of the Perlin lattice, textures requesting the same identifier share the same lattice.
+   */
+  NoiseTexture GetNoise(float scale, uint32_t lattice = 0);
+
+  /**
+   * @return Number of live texture handles referring to the image at the given path.
+   */
+  [[nodiscard]] uint32_t ReferenceCount(const std::filesystem::path& path) const;
+
+  [[nodiscard]] TextureMemoryUsage MemoryUsage() const;
+
+  /**
+   * Releases the data no longer referenced by any texture handle.
+   */
+  void Purge();
+
+ private:
+  std::unordered_map<std::string, std::shared_ptr<const ImageData>> images_;
+  std::unordered_map<uint32_t, std::shared_ptr<const Perlin>> lattices_;
+
+  static std::string Key(const std::filesystem::path& path);
+};
+}  // namespace rt
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+namespace rt {
+/**
+ * Rectangle of the image, from the first row and column up to but excluding the second.
+ */
+struct Tile {
+  glm::i32vec2 rows{0, 0};
+  glm::i32vec2 columns{0, 0};
+
+  [[nodiscard]] inline int32_t Width() const { return columns[1] - columns[0]; }
+  [[nodiscard]] inline int32_t Height() const { return rows[1] - rows[0]; }
+  [[nodiscard]] inline int32_t Area() const { return Width() * Height(); }
+  [[nodiscard]] inline bool Empty() const { return Width() <= 0 || Height() <= 0; }
+
+  [[nodiscard]] inline Tile Intersection(const Tile& other) const {
+    return {{glm::max(rows[0], other.rows[0]), glm::min(rows[1], other.rows[1])},
+            {glm::max(columns[0], other.columns[0]), glm::min(columns[1], other.columns[1])}};
+  }
+};
+}  // namespace rt
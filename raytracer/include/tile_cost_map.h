@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "tile_scheduler.h"
+
+namespace rt {
+/**
+ * Render time measured over the pixels of a region of an image, from which tiles of similar cost are cut.
+ */
+class TileCostMap {
+ public:
+  void Reset(const Tile& region);
+
+  /**
+   * Spreads the time a tile took evenly over its pixels. Tiles recorded concurrently must not overlap.
+   */
+  void Record(const Tile& tile, float seconds);
+
+  /**
+   * @return Tiles covering the region which are expected to take similar time, by recursively splitting it along the
+   * longer side. Neighbouring tiles stay close in the returned order.
+   */
+  [[nodiscard]] std::vector<Tile> BalancedTiles(int32_t tile_count) const;
+
+ private:
+  Tile region_;
+  // Size of the region, costs and the tiles cut from them are relative to its first pixel.
+  int32_t width_ = 0, height_ = 0;
+  std::vector<float> costs_;
+
+  void Split(const Tile& tile,
+             int32_t tile_count,
+             const std::vector<double>& summed_costs,
+             std::vector<Tile>& tiles) const;
+
+  [[nodiscard]] double Cost(const Tile& tile, const std::vector<double>& summed_costs) const;
+};
+}  // namespace rt
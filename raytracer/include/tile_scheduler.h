@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "BS_thread_pool.hpp"
+#include "glm/glm.hpp"
+
+#include "tile.h"
+
+namespace rt {
+/**
+ * Distributes tiles over the threads of a pool. Each thread works through a deque of its own and steals from the
+ * others once it runs out, tiles are split while threads are idle so that none is left with a large tile at the end.
+ */
+class TileScheduler {
+ public:
+  using TileFunction = std::function<void(const Tile&)>;
+
+  /**
+   * @return Square tiles covering the area, in the order of a Hilbert curve over the grid of tiles.
+   */
+  static std::vector<Tile> ChunkTiles(const Tile& area, int32_t chunk_size);
+
+  static std::vector<Tile> RowTiles(const Tile& area);
+
+  /**
+   * Runs the function on every tile and returns once all are done. Consecutive tiles start on the same thread.
+   */
+  void Run(BS::thread_pool& pool, const std::vector<Tile>& tiles, const TileFunction& function);
+
+ private:
+  // Owners take tiles from the front, thieves from the back, where the halves of split tiles are put as well.
+  struct alignas(64) Worker {
+    std::mutex mutex;
+    std::deque<Tile> tiles;
+  };
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<int32_t> pending_tiles_{0};
+  std::atomic<int32_t> idle_workers_{0};
+  // Changes whenever a tile is put into a deque or the last tile is done, idle threads sleep until it does.
+  std::atomic<uint32_t> work_generation_{0};
+
+  void Work(size_t worker, const TileFunction& function);
+
+  bool Pop(size_t worker, Tile& tile);
+
+  bool Steal(size_t thief, Tile& tile);
+};
+}  // namespace rt
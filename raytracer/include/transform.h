@@ -21,9 +21,20 @@ class Transform : public Collidable<Transform> {
 
   [[nodiscard]] glm::vec3 Centroid() const;
 
+  [[nodiscard]] float Area() const;
+
+  [[nodiscard]] const material_t* GetMaterial() const;
+
+  [[nodiscard]] DirectionCone NormalBounds() const;
+
   [[nodiscard]] float PDFValue(const glm::vec3& origin, const glm::vec3& direction) const;
 
-  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin) const;
+  [[nodiscard]] glm::vec3 RandomTowards(const glm::vec3& origin, Sampler& sampler) const;
+
+  /**
+   * Moves the collidable, hierarchies containing it have to be refit.
+   */
+  void SetTransformation(float rotate_y, glm::vec3 translate);
 
  private:
   transformable_t collidable_;
@@ -5,7 +5,7 @@
 
 #include "glm/glm.hpp"
 
-#include "image.h"
+#include "framebuffer.h"
 
 namespace rt::utils {
 
@@ -13,11 +13,17 @@ uint32_t ColorToRGBA(const glm::vec4& color);
 
 bool IsNearZero(const glm::vec3& vec);
 
+float Luminance(const glm::vec3& color);
+
 namespace png {
 
 std::vector<uint8_t> Decode(const std::filesystem::path& path, int32_t& width, int32_t& height);
 
-void Encode(const std::filesystem::path& path, const Image& image);
+/**
+ * Writes the front buffer of the framebuffer.
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void Encode(const std::filesystem::path& path, const Framebuffer& framebuffer);
 
 }  // namespace rt::utils::png
 
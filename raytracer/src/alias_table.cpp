@@ -0,0 +1,61 @@
+#include "alias_table.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace rt {
+AliasTable::AliasTable(const std::vector<float>& weights) : bins_(weights.size()) {
+  const auto n = static_cast<uint32_t>(weights.size());
+  if (n == 0) return;
+  const float sum = std::accumulate(weights.begin(), weights.end(), 0.0f);
+  for (uint32_t i = 0; i < n; ++i) {
+    bins_[i].pmf = sum > 0.0f ? weights[i] / sum : 1.0f / static_cast<float>(n);
+  }
+
+  // Scale the probabilities so that the average bin is 1, then pair each under-full bin with an over-full one.
+  std::vector<uint32_t> under, over;
+  std::vector<float> scaled(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    scaled[i] = bins_[i].pmf * static_cast<float>(n);
+    (scaled[i] < 1.0f ? under : over).push_back(i);
+  }
+  while (!under.empty() && !over.empty()) {
+    const uint32_t small = under.back();
+    under.pop_back();
+    const uint32_t large = over.back();
+    over.pop_back();
+    bins_[small].probability = scaled[small];
+    bins_[small].alias = large;
+    scaled[large] -= 1.0f - scaled[small];
+    (scaled[large] < 1.0f ? under : over).push_back(large);
+  }
+  // Leftovers are full up to floating point error.
+  for (const uint32_t i : under) {
+    bins_[i].probability = 1.0f;
+    bins_[i].alias = i;
+  }
+  for (const uint32_t i : over) {
+    bins_[i].probability = 1.0f;
+    bins_[i].alias = i;
+  }
+}
+
+uint32_t AliasTable::Sample(float u, float& pmf) const {
+  const auto n = static_cast<uint32_t>(bins_.size());
+  const float scaled = u * static_cast<float>(n);
+  const uint32_t index = std::min(static_cast<uint32_t>(scaled), n - 1);
+  const float remainder = std::min(scaled - static_cast<float>(index), 1.0f);
+  const uint32_t sampled = remainder < bins_[index].probability ? index : bins_[index].alias;
+  pmf = bins_[sampled].pmf;
+  return sampled;
+}
+
+float AliasTable::PMF(uint32_t index) const {
+  return bins_[index].pmf;
+}
+
+uint32_t AliasTable::Size() const {
+  return static_cast<uint32_t>(bins_.size());
+}
+
+}  // namespace rt
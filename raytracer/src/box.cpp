@@ -2,6 +2,8 @@
 
 #include <utility>
 
+#include "sampler.h"
+
 namespace rt {
 Box::Box(glm::vec3 min_point, glm::vec3 max_point, material_t material)
     : min_point_{min_point},
@@ -42,13 +44,40 @@ glm::vec3 Box::Centroid() const {
   return min_point_ + (max_point_ - min_point_) * 0.5f;
 }
 
+float Box::Area() const {
+  const glm::vec3 extent = max_point_ - min_point_;
+  return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+const material_t* Box::GetMaterial() const {
+  return &material_;
+}
+
+DirectionCone Box::NormalBounds() const {
+  return DirectionCone::Entire();
+}
+
 float Box::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  // RandomTowards picks a side proportionally to its area, so the density is the area-weighted sum over the sides.
+  const float area = Area();
+  float value = 0.0f;
+  for (const auto& side : sides_) {
+    value += std::visit([&](const auto& rectangle) {
+      return rectangle.Area() / area * rectangle.PDFValue(origin, direction);
+    }, side);
+  }
+  return value;
 }
 
-glm::vec3 Box::RandomTowards(const glm::vec3& origin) const {
-  // TODO
+glm::vec3 Box::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  float target = sampler.Get1D() * Area();
+  for (const auto& side : sides_) {
+    const float side_area = std::visit([](const auto& rectangle) { return rectangle.Area(); }, side);
+    if (target < side_area || &side == &sides_.back()) {
+      return std::visit([&](const auto& rectangle) { return rectangle.RandomTowards(origin, sampler); }, side);
+    }
+    target -= side_area;
+  }
   return {0.0f, 0.0f, 0.0f};
 }
 
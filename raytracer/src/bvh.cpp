@@ -4,7 +4,6 @@
 #include <array>
 #include <cassert>
 #include <limits>
-#include <variant>
 
 #include "box.h"
 #include "rectangle.h"
@@ -13,27 +12,52 @@
 
 namespace rt {
 
-BVH::BVH(BVHSplitStrategy split_strategy, collidable_container_t& primitives, float time0, float time1)
-    : primitives_{primitives}, split_strategy_{split_strategy}, time0_{time0}, time1_{time1} {
+BVH::BVH(BVHSplitStrategy split_strategy, const collidable_pool_t& collidables, float time0, float time1)
+    : split_strategy_{split_strategy},
+      collidables_{collidables},
+      primitives_{collidables.References()},
+      time0_{time0},
+      time1_{time1} {
   const auto n = static_cast<uint32_t>(primitives_.size());
   nodes_.reserve(2 * n);
   BVHNode& root = nodes_.emplace_back(0, n);
   ComputeNodeAABB(root);
   Partition(root);
+  SortLeavesByType();
 }
 
 bool BVH::Collide(const Ray& ray, float t_min, float t_max, Collision& collision) const {
   return TraverseRecursive(nodes_[0], ray, t_min, t_max, collision);
 }
 
+void BVH::Refit() {
+  if (primitives_.empty()) return;
+  // Children are appended after their parent, so visiting the nodes backwards refits the children first.
+  for (auto node = nodes_.rbegin(); node != nodes_.rend(); ++node) {
+    if (node->primitive_count > 0) {
+      node->bounding_box = {};
+      ComputeNodeAABB(*node);
+    } else {
+      node->bounding_box = AABB::SurroundingBox(nodes_[node->first_primitive_offset].bounding_box,
+                                                nodes_[node->first_primitive_offset + 1].bounding_box);
+    }
+  }
+}
+
+AABB BVH::PrimitiveBoundingBox(CollidableReference primitive) const {
+  AABB bounding_box;
+  collidables_.Visit(primitive, [&](const auto& collidable) {
+    collidable.BoundingBox(time0_, time1_, bounding_box);
+  });
+  return bounding_box;
+}
+
 float BVH::ComputeSurfaceAreaHeuristic(const BVHNode& node, int32_t split_axis, float split_position) const {
   AABB bounding_box;
   AABB left_box, right_box;
   uint32_t left_count = 0, right_count = 0;
   for (uint32_t i = 0; i < node.primitive_count; ++i) {
-    AABB primitive_bounding_box;
-    std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, primitive_bounding_box); },
-               primitives_[node.first_primitive_offset + i]);
+    const AABB primitive_bounding_box = PrimitiveBoundingBox(primitives_[node.first_primitive_offset + i]);
     bounding_box = AABB::SurroundingBox(bounding_box, primitive_bounding_box);
     if (primitive_bounding_box.Centroid()[split_axis] < split_position) {
       left_box = AABB::SurroundingBox(left_box, primitive_bounding_box);
@@ -50,9 +74,7 @@ float BVH::ComputeSurfaceAreaHeuristic(const BVHNode& node, int32_t split_axis,
 
 void BVH::ComputeNodeAABB(BVHNode& node) {
   for (uint32_t i = 0; i < node.primitive_count; ++i) {
-    AABB primitive_bounding_box;
-    std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, primitive_bounding_box); },
-               primitives_[node.first_primitive_offset + i]);
+    const AABB primitive_bounding_box = PrimitiveBoundingBox(primitives_[node.first_primitive_offset + i]);
     node.bounding_box = AABB::SurroundingBox(node.bounding_box, primitive_bounding_box);
   }
 }
@@ -69,11 +91,8 @@ void BVH::Partition(BVHNode& node) {
       best_split_position = node.bounding_box.Centroid()[best_axis];
       partition_middle = std::partition(
           begin, end,
-          [&](const auto& primitive) {
-            AABB primitive_bounding_box;
-            std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, primitive_bounding_box); },
-                       primitive);
-            return primitive_bounding_box.Centroid()[best_axis] < best_split_position;
+          [&](CollidableReference primitive) {
+            return PrimitiveBoundingBox(primitive).Centroid()[best_axis] < best_split_position;
           });
       // If partitioning at the middle produced a reasonable result, we're done.
       // Otherwise, fallthrough to EqualCounts as a fallback partitioning method.
@@ -82,11 +101,8 @@ void BVH::Partition(BVHNode& node) {
     case BVHSplitStrategy::EqualCounts: {
       if (node.primitive_count == 1) return;
       partition_middle = begin + (end - begin) / 2;
-      std::nth_element(begin, partition_middle, end, [&](const auto& a, const auto& b) {
-        AABB a_box, b_box;
-        std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, a_box); }, a);
-        std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, b_box); }, b);
-        return a_box.Centroid()[best_axis] < b_box.Centroid()[best_axis];
+      std::nth_element(begin, partition_middle, end, [&](CollidableReference a, CollidableReference b) {
+        return PrimitiveBoundingBox(a).Centroid()[best_axis] < PrimitiveBoundingBox(b).Centroid()[best_axis];
       });
       break;
     }
@@ -94,9 +110,7 @@ void BVH::Partition(BVHNode& node) {
       float best_cost = std::numeric_limits<float>::max();
       for (int32_t axis = 0; axis < 3; ++axis) {
         for (uint32_t i = 0; i < node.primitive_count; ++i) {
-          AABB primitive_bounding_box;
-          std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, primitive_bounding_box); },
-                     primitives_[node.first_primitive_offset + i]);
+          const AABB primitive_bounding_box = PrimitiveBoundingBox(primitives_[node.first_primitive_offset + i]);
           const float candidate_position = primitive_bounding_box.Centroid()[axis];
           const float cost = ComputeSurfaceAreaHeuristic(node, axis, candidate_position);
           if (cost < best_cost) {
@@ -113,11 +127,8 @@ void BVH::Partition(BVHNode& node) {
       }
       partition_middle = std::partition(
           begin, end,
-          [&](const auto& primitive) {
-            AABB primitive_bounding_box;
-            std::visit([&](const auto& primitive) { primitive.BoundingBox(time0_, time1_, primitive_bounding_box); },
-                       primitive);
-            return primitive_bounding_box.Centroid()[best_axis] < best_split_position;
+          [&](CollidableReference primitive) {
+            return PrimitiveBoundingBox(primitive).Centroid()[best_axis] < best_split_position;
           });
       break;
     }
@@ -140,18 +151,42 @@ void BVH::Partition(BVHNode& node) {
   Partition(right);
 }
 
+void BVH::SortLeavesByType() {
+  for (const BVHNode& node : nodes_) {
+    if (node.primitive_count == 0) continue;
+    const auto begin = primitives_.begin() + node.first_primitive_offset;
+    std::sort(begin, begin + node.primitive_count, [](CollidableReference a, CollidableReference b) {
+      return a.type < b.type || (a.type == b.type && a.index < b.index);
+    });
+  }
+}
+
+bool BVH::CollideLeaf(const BVHNode& node, const Ray& ray, float t_min, float t_max, Collision& collision) const {
+  bool collided = false;
+  const uint32_t end = node.first_primitive_offset + node.primitive_count;
+  uint32_t run_begin = node.first_primitive_offset;
+  while (run_begin < end) {
+    // Intersect each run of same-typed primitives in a homogeneous loop over the type's pool.
+    const uint32_t type = primitives_[run_begin].type;
+    uint32_t run_end = run_begin + 1;
+    while (run_end < end && primitives_[run_end].type == type) ++run_end;
+    collidables_.VisitPool(type, [&](const auto& pool) {
+      for (uint32_t i = run_begin; i < run_end; ++i) {
+        if (pool[primitives_[i].index].Collide(ray, t_min, t_max, collision)) {
+          collided = true;
+          t_max = collision.t;
+        }
+      }
+    });
+    run_begin = run_end;
+  }
+  return collided;
+}
+
 bool BVH::TraverseRecursive(const BVHNode& node, const Ray& ray, float t_min, float t_max, Collision& collision) const {
   if (!node.bounding_box.Collide(ray, t_min, t_max)) return false;
   if (node.primitive_count > 0) {
-    bool collided = false;
-    for (uint32_t i = 0; i < node.primitive_count; ++i) {
-      if (std::visit([&](const auto& primitive) { return primitive.Collide(ray, t_min, t_max, collision); },
-                     primitives_[node.first_primitive_offset + i])) {
-        collided = true;
-        t_max = collision.t;
-      }
-    }
-    return collided;
+    return CollideLeaf(node, ray, t_min, t_max, collision);
   } else {
     const BVHNode& left = nodes_[node.first_primitive_offset];
     const BVHNode& right = nodes_[node.first_primitive_offset + 1];
@@ -12,7 +12,7 @@ Camera::Camera(glm::vec3 origin,
                float focus_distance,
                float time0,
                float time1)
-    : origin_{origin}, lens_radius_(aperture / 2.0f), time0_{time0}, time1_{time1} {
+    : aspect_ratio_{aspect_ratio}, origin_{origin}, lens_radius_(aperture / 2.0f), time0_{time0}, time1_{time1} {
   const float theta = glm::radians(vertical_fov);
   const float h = glm::tan(theta / 2.0f);
   const float viewport_height = 2.0f * h;
@@ -27,12 +27,19 @@ Camera::Camera(glm::vec3 origin,
   lower_left_corner_ = origin - horizontal_ / 2.0f - vertical_ / 2.0f - focus_distance * w_;
 }
 
-Ray Camera::ShootRay(const glm::vec2& coordinate) const {
-  const glm::vec3 random_in_lens = lens_radius_ * random::InUnitDisk();
+Ray Camera::ShootRay(const glm::vec2& coordinate, Sampler& sampler) const {
+  const glm::vec3 random_in_lens = lens_radius_ * random::InUnitDisk(sampler.Get2D());
   const glm::vec3 offset = u_ * random_in_lens.x + v_ * random_in_lens.y;
   return {origin_ + offset,
           lower_left_corner_ + coordinate.x * horizontal_ + coordinate.y * vertical_ - origin_ - offset,
-          random::Float(time0_, time1_)};
+          glm::mix(time0_, time1_, sampler.Get1D())};
+}
+
+void Camera::SetAspectRatio(float aspect_ratio) {
+  const glm::vec3 horizontal = horizontal_ * (aspect_ratio / aspect_ratio_);
+  lower_left_corner_ += (horizontal_ - horizontal) / 2.0f;
+  horizontal_ = horizontal;
+  aspect_ratio_ = aspect_ratio;
 }
 
 }  // namespace rt
@@ -34,7 +34,9 @@ bool ConstantMedium::Collide(const Ray& ray, float t_min, float t_max, Collision
 
   const float ray_length = glm::length(ray.Direction());
   const float distance_inside_boundary = (collision_2.t - collision_1.t) * ray_length;
-  const float hit_distance = negative_inverse_density_ * glm::log(random::Float());
+  // No sampler is passed to Collide(), the free path is derived from the ray to keep it reproducible.
+  random::Generator generator{random::Hash(ray.Origin(), ray.Direction())};
+  const float hit_distance = negative_inverse_density_ * glm::log(1.0f - random::Float(generator));
   if (hit_distance > distance_inside_boundary) return false;
   collision.t = collision_1.t + hit_distance / ray_length;
   collision.point = ray.At(collision.t);
@@ -51,14 +53,25 @@ glm::vec3 ConstantMedium::Centroid() const {
   return std::visit([](const auto& primitive) { return primitive.Centroid(); }, boundary_);
 }
 
+float ConstantMedium::Area() const {
+  return std::visit([](const auto& primitive) { return primitive.Area(); }, boundary_);
+}
+
+const material_t* ConstantMedium::GetMaterial() const {
+  return &phase_function_;
+}
+
+DirectionCone ConstantMedium::NormalBounds() const {
+  return DirectionCone::Entire();
+}
+
 float ConstantMedium::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  // Directions towards the medium are those towards its boundary.
+  return std::visit([&](const auto& primitive) { return primitive.PDFValue(origin, direction); }, boundary_);
 }
 
-glm::vec3 ConstantMedium::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 ConstantMedium::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  return std::visit([&](const auto& primitive) { return primitive.RandomTowards(origin, sampler); }, boundary_);
 }
 
 }  // namespace rt
@@ -0,0 +1,32 @@
+#include "direction_cone.h"
+
+#include <algorithm>
+#include <numbers>
+
+namespace rt {
+DirectionCone DirectionCone::Entire() {
+  return {glm::vec3{0.0f, 0.0f, 1.0f}, -1.0f};
+}
+
+DirectionCone DirectionCone::Union(const DirectionCone& a, const DirectionCone& b) {
+  if (a.IsEntire() || b.IsEntire()) return Entire();
+  constexpr float kPi = std::numbers::pi_v<float>;
+  const float theta_a = glm::acos(std::clamp(a.cos_theta, -1.0f, 1.0f));
+  const float theta_b = glm::acos(std::clamp(b.cos_theta, -1.0f, 1.0f));
+  const float theta_d = glm::acos(std::clamp(glm::dot(a.axis, b.axis), -1.0f, 1.0f));
+  // One cone contains the other.
+  if (std::min(theta_d + theta_b, kPi) <= theta_a) return a;
+  if (std::min(theta_d + theta_a, kPi) <= theta_b) return b;
+
+  const float theta_o = (theta_a + theta_d + theta_b) / 2.0f;
+  if (theta_o >= kPi) return Entire();
+  // Rotate a's axis towards b's axis so that the merged cone covers both.
+  const float theta_r = theta_o - theta_a;
+  const glm::vec3 rotation_axis = glm::cross(a.axis, b.axis);
+  if (glm::dot(rotation_axis, rotation_axis) == 0.0f) return Entire();
+  const glm::vec3 k = glm::normalize(rotation_axis);
+  const glm::vec3 axis = a.axis * glm::cos(theta_r) + glm::cross(k, a.axis) * glm::sin(theta_r);
+  return {glm::normalize(axis), glm::cos(theta_o)};
+}
+
+}  // namespace rt
@@ -23,14 +23,26 @@ glm::vec3 Flip::Centroid() const {
   return std::visit([](const auto& primitive) { return primitive.Centroid(); }, primitive_);
 }
 
+float Flip::Area() const {
+  return std::visit([](const auto& primitive) { return primitive.Area(); }, primitive_);
+}
+
+const material_t* Flip::GetMaterial() const {
+  return std::visit([](const auto& primitive) { return primitive.GetMaterial(); }, primitive_);
+}
+
+DirectionCone Flip::NormalBounds() const {
+  DirectionCone normals = std::visit([](const auto& primitive) { return primitive.NormalBounds(); }, primitive_);
+  normals.axis = -normals.axis;
+  return normals;
+}
+
 float Flip::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  return std::visit([&](const auto& primitive) { return primitive.PDFValue(origin, direction); }, primitive_);
 }
 
-glm::vec3 Flip::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 Flip::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  return std::visit([&](const auto& primitive) { return primitive.RandomTowards(origin, sampler); }, primitive_);
 }
 
 }  // namespace rt
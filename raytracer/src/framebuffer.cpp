@@ -0,0 +1,58 @@
+#include "framebuffer.h"
+
+#include <algorithm>
+
+namespace rt {
+void Framebuffer::Resize(int32_t width, int32_t height) {
+  width_ = width;
+  height_ = height;
+  horizontal_blocks_ = (width + kBlockSize - 1) / kBlockSize;
+  const int32_t vertical_blocks = (height + kBlockSize - 1) / kBlockSize;
+  back_.assign(static_cast<size_t>(width) * height, 0);
+  front_.assign(static_cast<size_t>(width) * height, 0);
+  blocks_ = std::vector<Block>(static_cast<size_t>(horizontal_blocks_) * vertical_blocks);
+}
+
+void Framebuffer::Publish(const Tile& tile, const uint32_t* pixels) {
+  for (int32_t block_row = tile.rows[0] / kBlockSize; block_row * kBlockSize < tile.rows[1]; ++block_row) {
+    for (int32_t block_column = tile.columns[0] / kBlockSize; block_column * kBlockSize < tile.columns[1];
+         ++block_column) {
+      const Tile block_tile = BlockTile(block_row, block_column);
+      const glm::i32vec2 rows{std::max(tile.rows[0], block_tile.rows[0]), std::min(tile.rows[1], block_tile.rows[1])};
+      const glm::i32vec2 columns{std::max(tile.columns[0], block_tile.columns[0]),
+                                 std::min(tile.columns[1], block_tile.columns[1])};
+      Block& block = blocks_[block_row * horizontal_blocks_ + block_column];
+      std::lock_guard lock{block.mutex};
+      for (int32_t row = rows[0]; row < rows[1]; ++row) {
+        std::copy_n(pixels + (row - tile.rows[0]) * tile.Width() + (columns[0] - tile.columns[0]),
+                    columns[1] - columns[0],
+                    back_.begin() + row * width_ + columns[0]);
+      }
+      block.ready.store(true, std::memory_order_release);
+    }
+  }
+}
+
+std::vector<Tile> Framebuffer::Flip() {
+  std::vector<Tile> regions;
+  for (size_t index = 0; index < blocks_.size(); ++index) {
+    Block& block = blocks_[index];
+    if (!block.ready.exchange(false, std::memory_order_acquire)) continue;
+    const Tile block_tile = BlockTile(static_cast<int32_t>(index) / horizontal_blocks_,
+                                      static_cast<int32_t>(index) % horizontal_blocks_);
+    std::lock_guard lock{block.mutex};
+    for (int32_t row = block_tile.rows[0]; row < block_tile.rows[1]; ++row) {
+      std::copy_n(back_.begin() + row * width_ + block_tile.columns[0],
+                  block_tile.Width(),
+                  front_.begin() + row * width_ + block_tile.columns[0]);
+    }
+    regions.push_back(block_tile);
+  }
+  return regions;
+}
+
+Tile Framebuffer::BlockTile(int32_t block_row, int32_t block_column) const {
+  return {{block_row * kBlockSize, std::min((block_row + 1) * kBlockSize, height_)},
+          {block_column * kBlockSize, std::min((block_column + 1) * kBlockSize, width_)}};
+}
+}  // namespace rt
@@ -0,0 +1,49 @@
+#include "framebuffer_sink.h"
+
+#include <format>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#include "renderer.h"
+#include "utils.h"
+
+namespace rt {
+FramebufferSink MakeFramebufferSink(Framebuffer& framebuffer) {
+  return {
+      .on_tile = [&framebuffer](const Tile& tile, const uint32_t* pixels) { framebuffer.Publish(tile, pixels); },
+  };
+}
+
+FramebufferSink MakePNGSink(const std::filesystem::path& path, int32_t width, int32_t height) {
+  auto framebuffer = std::make_shared<Framebuffer>();
+  framebuffer->Resize(width, height);
+  return {
+      .on_tile = [framebuffer](const Tile& tile, const uint32_t* pixels) { framebuffer->Publish(tile, pixels); },
+      .on_finish = [framebuffer, path](const RendererStatistics&) {
+        framebuffer->Flip();
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+        utils::png::Encode(path, *framebuffer);
+      },
+  };
+}
+
+FramebufferSink MakeStatisticsSink(const std::filesystem::path& path) {
+  return {
+      .on_finish = [path](const RendererStatistics& statistics) {
+        std::ofstream file{path};
+        file << "width: " << statistics.width << '\n'
+             << "height: " << statistics.height << '\n'
+             << "scene_time_ms: " << statistics.scene_time_ms.count() << '\n'
+             << "render_time_ms: " << statistics.render_time_ms.count() << '\n'
+             << "passes: " << statistics.passes << '\n'
+             << "average_samples_per_pixel: " << statistics.average_samples_per_pixel << '\n'
+             << "estimated_error: " << statistics.estimated_error << '\n'
+             << "texture_memory_bytes: " << statistics.texture_memory.TotalBytes() << '\n'
+             << "cancelled: " << (statistics.cancelled ? "true" : "false") << '\n';
+        file.close();
+        if (!file) throw std::runtime_error{std::format("Failed to write the statistics to {}.", path.string())};
+      },
+  };
+}
+}  // namespace rt
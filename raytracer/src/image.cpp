@@ -1,23 +1,17 @@
 #include "image.h"
 
 namespace rt {
-Image::Image(int32_t width, int32_t height, uint32_t* data)
-    : width_{width}, height_{height}, data_{data} {
-  glGenBuffers(1, &buffer_);
-  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_);
-
+Image::Image(Framebuffer& framebuffer) : framebuffer_{&framebuffer} {
   glGenTextures(1, &texture_);
-  glBindTexture(GL_TEXTURE_2D, texture_);
-
-  Update();
+  Resize();
 }
 
 void Image::Update() const {
-  const GLsizeiptr kBufferSize =
-      static_cast<GLsizeiptr>(width_) * static_cast<GLsizeiptr>(height_) * static_cast<GLsizeiptr>(sizeof(uint32_t));
-  glBufferData(GL_PIXEL_UNPACK_BUFFER, kBufferSize, nullptr, GL_DYNAMIC_DRAW);
-  glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, kBufferSize, data_);
+  Upload(framebuffer_->Flip());
+}
 
+void Image::Resize() {
+  glBindTexture(GL_TEXTURE_2D, texture_);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 
@@ -27,20 +21,32 @@ void Image::Update() const {
   glTexImage2D(GL_TEXTURE_2D,
                0,
                GL_RGBA,
-               static_cast<GLsizei>(width_),
-               static_cast<GLsizei>(height_),
+               static_cast<GLsizei>(Width()),
+               static_cast<GLsizei>(Height()),
                0,
                GL_RGBA,
                GL_UNSIGNED_INT_8_8_8_8_REV,
                nullptr);
+  Upload({{{0, Height()}, {0, Width()}}});
 }
 
-void Image::Resize(int32_t width, int32_t height, uint32_t* data) {
-  if (texture_ && width_ == width && height_ == height) return;
-  width_ = width;
-  height_ = height;
-  data_ = data;
-  Update();
+void Image::Upload(const std::vector<Tile>& regions) const {
+  if (regions.empty()) return;
+  glBindTexture(GL_TEXTURE_2D, texture_);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, Width());
+  for (const Tile& region : regions) {
+    if (region.Area() == 0) continue;
+    glTexSubImage2D(GL_TEXTURE_2D,
+                    0,
+                    region.columns[0],
+                    region.rows[0],
+                    region.Width(),
+                    region.Height(),
+                    GL_RGBA,
+                    GL_UNSIGNED_INT_8_8_8_8_REV,
+                    Buffer() + region.rows[0] * Width() + region.columns[0]);
+  }
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 }
-
 }  // namespace rt
@@ -0,0 +1,98 @@
+#include "light_list.h"
+
+#include <cassert>
+#include <numbers>
+#include <variant>
+
+#include "sampler.h"
+#include "utils.h"
+
+namespace rt {
+LightList::LightList(const collidable_pool_t& collidables) : collidables_{&collidables} {
+  std::vector<float> powers;
+  for (const CollidableReference collidable : collidables.References()) {
+    collidables.Visit(collidable, [&](const auto& object) {
+      const material_t* material = object.GetMaterial();
+      if (material == nullptr || !std::holds_alternative<DiffuseLight>(*material)) return;
+      // Lambertian emitter: power = pi * area * radiance.
+      const glm::vec3 radiance = std::get<DiffuseLight>(*material).AverageEmission();
+      const float power = std::numbers::pi_v<float> * object.Area() * utils::Luminance(radiance);
+      if (power <= 0.0f) return;
+      lights_.push_back(collidable);
+      powers.push_back(power);
+    });
+  }
+  distribution_ = AliasTable{powers};
+  tree_ = LightTree{collidables, lights_, powers};
+}
+
+bool LightList::Empty() const {
+  return lights_.empty();
+}
+
+uint32_t LightList::Size() const {
+  return static_cast<uint32_t>(lights_.size());
+}
+
+bool LightList::Sample(const glm::vec3& origin,
+                       const glm::vec3& normal,
+                       float u,
+                       LightSamplingStrategy strategy,
+                       CollidableReference& light,
+                       float& pmf) const {
+  if (lights_.empty()) return false;
+  switch (strategy) {
+    case LightSamplingStrategy::PowerProportional: {
+      light = lights_[distribution_.Sample(u, pmf)];
+      return true;
+    }
+    case LightSamplingStrategy::LightBVH: {
+      uint32_t index;
+      if (!tree_.Sample(origin, normal, u, index, pmf)) return false;
+      light = lights_[index];
+      return true;
+    }
+    default: {
+      assert(false);
+      return false;
+    }
+  }
+}
+
+float LightList::PDFValue(const glm::vec3& origin,
+                          const glm::vec3& normal,
+                          const glm::vec3& direction,
+                          LightSamplingStrategy strategy) const {
+  switch (strategy) {
+    case LightSamplingStrategy::PowerProportional: {
+      float value = 0.0f;
+      for (uint32_t i = 0; i < Size(); ++i) {
+        value += distribution_.PMF(i) * collidables_->Visit(lights_[i], [&](const auto& light) {
+          return light.PDFValue(origin, direction);
+        });
+      }
+      return value;
+    }
+    case LightSamplingStrategy::LightBVH: {
+      return tree_.PDFValue(origin, normal, direction);
+    }
+    default: {
+      assert(false);
+      return 0.0f;
+    }
+  }
+}
+
+glm::vec3 LightList::RandomTowards(const glm::vec3& origin,
+                                   const glm::vec3& normal,
+                                   LightSamplingStrategy strategy,
+                                   Sampler& sampler) const {
+  CollidableReference light;
+  float pmf;
+  if (!Sample(origin, normal, sampler.Get1D(), strategy, light, pmf)) return {0.0f, 0.0f, 0.0f};
+  return collidables_->Visit(light, [&](const auto& collidable) {
+    return collidable.RandomTowards(origin, sampler);
+  });
+}
+
+}  // namespace rt
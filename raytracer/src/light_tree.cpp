@@ -0,0 +1,229 @@
+#include "light_tree.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "ray.h"
+
+namespace rt {
+namespace {
+constexpr float kOneMinusEpsilon = 0x1.fffffep-1f;
+// Median splits of at most 2^32 lights stay within 32 levels, well within the bits of a trail.
+constexpr size_t kMaxDepth = 64;
+
+// cos(max(0, a - b)) and sin(max(0, a - b)) from the sines and cosines of a and b.
+float CosSubClamped(float sin_a, float cos_a, float sin_b, float cos_b) {
+  if (cos_a > cos_b) return 1.0f;
+  return cos_a * cos_b + sin_a * sin_b;
+}
+
+float SinSubClamped(float sin_a, float cos_a, float sin_b, float cos_b) {
+  if (cos_a > cos_b) return 0.0f;
+  return sin_a * cos_b - cos_a * sin_b;
+}
+
+float SinFromCos(float cos_theta) {
+  return glm::sqrt(std::max(0.0f, 1.0f - cos_theta * cos_theta));
+}
+}  // namespace
+
+float LightBounds::Importance(const glm::vec3& point, const glm::vec3& normal) const {
+  const glm::vec3 min_point = bounding_box.MinPoint();
+  const glm::vec3 max_point = bounding_box.MaxPoint();
+  const glm::vec3 centroid = 0.5f * (min_point + max_point);
+  const float radius = glm::length(max_point - min_point) / 2.0f;
+  const glm::vec3 offset = point - centroid;
+  const float actual_distance_squared = glm::dot(offset, offset);
+  // Avoid overestimating the importance of points close to or inside the bounds.
+  const float distance_squared = std::max(actual_distance_squared, radius);
+
+  // Angle between the normal bounds' axis and the direction towards the point.
+  const glm::vec3 towards_point = actual_distance_squared > 0.0f ? offset / glm::sqrt(actual_distance_squared)
+                                                                 : normals.axis;
+  const float cos_theta_w = glm::dot(normals.axis, towards_point);
+  const float sin_theta_w = SinFromCos(cos_theta_w);
+
+  // Angle subtended by the bounds as seen from the point.
+  const float cos_theta_b = actual_distance_squared < radius * radius
+                            ? -1.0f : glm::sqrt(1.0f - radius * radius / actual_distance_squared);
+  const float sin_theta_b = SinFromCos(cos_theta_b);
+
+  // Smallest possible angle between an emitter's normal and the direction towards the point.
+  const float cos_theta_o = normals.cos_theta;
+  const float sin_theta_o = SinFromCos(cos_theta_o);
+  const float cos_theta_x = CosSubClamped(sin_theta_w, cos_theta_w, sin_theta_o, cos_theta_o);
+  const float sin_theta_x = SinSubClamped(sin_theta_w, cos_theta_w, sin_theta_o, cos_theta_o);
+  const float cos_theta_p = CosSubClamped(sin_theta_x, cos_theta_x, sin_theta_b, cos_theta_b);
+  if (cos_theta_p <= cos_theta_e) return 0.0f;
+
+  float importance = power * cos_theta_p / distance_squared;
+  if (normal != glm::vec3{0.0f, 0.0f, 0.0f}) {
+    // Smallest possible incident angle at the receiving surface.
+    const float cos_theta_i = glm::abs(glm::dot(towards_point, glm::normalize(normal)));
+    const float sin_theta_i = SinFromCos(cos_theta_i);
+    importance *= CosSubClamped(sin_theta_i, cos_theta_i, sin_theta_b, cos_theta_b);
+  }
+  return std::max(importance, 0.0f);
+}
+
+LightBounds LightBounds::Union(const LightBounds& a, const LightBounds& b) {
+  if (a.power == 0.0f) return b;
+  if (b.power == 0.0f) return a;
+  return {AABB::SurroundingBox(a.bounding_box, b.bounding_box),
+          DirectionCone::Union(a.normals, b.normals),
+          std::min(a.cos_theta_e, b.cos_theta_e),
+          a.power + b.power};
+}
+
+LightTree::LightTree(const collidable_pool_t& collidables,
+                     const std::vector<CollidableReference>& lights,
+                     const std::vector<float>& powers)
+    : collidables_{&collidables}, lights_{lights}, trails_(lights.size()) {
+  if (lights_.empty()) return;
+  std::vector<LightBounds> bounds(lights_.size());
+  for (uint32_t i = 0; i < static_cast<uint32_t>(lights_.size()); ++i) {
+    collidables.Visit(lights_[i], [&](const auto& light) {
+      light.BoundingBox(0.0f, 1.0f, bounds[i].bounding_box);
+      bounds[i].normals = light.NormalBounds();
+    });
+    bounds[i].power = powers[i];
+  }
+  std::vector<uint32_t> indices(lights_.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  nodes_.reserve(2 * lights_.size() - 1);
+  Build(indices.begin(), indices.end(), bounds, 0, 0);
+}
+
+bool LightTree::Sample(const glm::vec3& point, const glm::vec3& normal, float u, uint32_t& light, float& pmf) const {
+  if (nodes_.empty()) return false;
+  uint32_t node = 0;
+  pmf = 1.0f;
+  while (!nodes_[node].leaf) {
+    const float left_probability = LeftProbability(node, point, normal);
+    if (left_probability < 0.0f) return false;
+    if (u < left_probability) {
+      u = std::min(u / left_probability, kOneMinusEpsilon);
+      pmf *= left_probability;
+      node = node + 1;
+    } else {
+      u = std::min((u - left_probability) / (1.0f - left_probability), kOneMinusEpsilon);
+      pmf *= 1.0f - left_probability;
+      node = nodes_[node].offset;
+    }
+  }
+  // Interior nodes have already rejected the light if it does not contribute, unless it is the only one.
+  if (node == 0 && nodes_[node].bounds.Importance(point, normal) <= 0.0f) return false;
+  light = nodes_[node].offset;
+  return true;
+}
+
+float LightTree::PMF(const glm::vec3& point, const glm::vec3& normal, uint32_t light) const {
+  if (nodes_.empty()) return 0.0f;
+  uint64_t trail = trails_[light];
+  uint32_t node = 0;
+  float pmf = 1.0f;
+  while (!nodes_[node].leaf) {
+    const float left_probability = LeftProbability(node, point, normal);
+    if (left_probability < 0.0f) return 0.0f;
+    if (trail & 1) {
+      pmf *= 1.0f - left_probability;
+      node = nodes_[node].offset;
+    } else {
+      pmf *= left_probability;
+      node = node + 1;
+    }
+    trail >>= 1;
+  }
+  if (node == 0 && nodes_[node].bounds.Importance(point, normal) <= 0.0f) return 0.0f;
+  return pmf;
+}
+
+float LightTree::PDFValue(const glm::vec3& point, const glm::vec3& normal, const glm::vec3& direction) const {
+  if (nodes_.empty()) return 0.0f;
+  if (nodes_[0].leaf) {
+    if (nodes_[0].bounds.Importance(point, normal) <= 0.0f) return 0.0f;
+    return LightPDFValue(nodes_[0].offset, point, direction);
+  }
+
+  // Only the lights whose bounds the direction hits can have a non-zero density.
+  const Ray ray{point, direction};
+  float value = 0.0f;
+  // Nodes to visit with the probability of reaching them, a traversal holds at most one per level besides the current.
+  std::array<std::pair<uint32_t, float>, kMaxDepth + 1> stack;
+  size_t stack_size = 0;
+  stack[stack_size++] = {0, 1.0f};
+  while (stack_size > 0) {
+    const auto [node, pmf] = stack[--stack_size];
+    if (nodes_[node].leaf) {
+      value += pmf * LightPDFValue(nodes_[node].offset, point, direction);
+      continue;
+    }
+    const float left_probability = LeftProbability(node, point, normal);
+    if (left_probability < 0.0f) continue;
+    const uint32_t left = node + 1;
+    const uint32_t right = nodes_[node].offset;
+    if (left_probability > 0.0f
+        && nodes_[left].bounds.bounding_box.Collide(ray, 0.001f, std::numeric_limits<float>::max())) {
+      stack[stack_size++] = {left, pmf * left_probability};
+    }
+    if (left_probability < 1.0f
+        && nodes_[right].bounds.bounding_box.Collide(ray, 0.001f, std::numeric_limits<float>::max())) {
+      stack[stack_size++] = {right, pmf * (1.0f - left_probability)};
+    }
+  }
+  return value;
+}
+
+uint32_t LightTree::Build(std::vector<uint32_t>::iterator begin,
+                          std::vector<uint32_t>::iterator end,
+                          const std::vector<LightBounds>& bounds,
+                          uint64_t trail,
+                          uint32_t depth) {
+  const auto node = static_cast<uint32_t>(nodes_.size());
+  nodes_.emplace_back();
+  if (end - begin == 1) {
+    nodes_[node].bounds = bounds[*begin];
+    nodes_[node].offset = *begin;
+    nodes_[node].leaf = true;
+    trails_[*begin] = trail;
+    return node;
+  }
+
+  // Split at the median centroid along the longest axis of the centroids' bounds.
+  AABB centroid_bounds;
+  for (auto it = begin; it != end; ++it) {
+    const glm::vec3 centroid = bounds[*it].bounding_box.Centroid();
+    centroid_bounds = AABB::SurroundingBox(centroid_bounds, AABB{centroid, centroid});
+  }
+  const int32_t axis = centroid_bounds.LongestAxis();
+  const auto middle = begin + (end - begin) / 2;
+  std::nth_element(begin, middle, end, [&](uint32_t a, uint32_t b) {
+    return bounds[a].bounding_box.Centroid()[axis] < bounds[b].bounding_box.Centroid()[axis];
+  });
+
+  Build(begin, middle, bounds, trail, depth + 1);
+  const uint32_t right = Build(middle, end, bounds, trail | (uint64_t{1} << depth), depth + 1);
+  nodes_[node].bounds = LightBounds::Union(nodes_[node + 1].bounds, nodes_[right].bounds);
+  nodes_[node].offset = right;
+  return node;
+}
+
+float LightTree::LeftProbability(uint32_t node, const glm::vec3& point, const glm::vec3& normal) const {
+  const float left_importance = nodes_[node + 1].bounds.Importance(point, normal);
+  const float right_importance = nodes_[nodes_[node].offset].bounds.Importance(point, normal);
+  const float importance = left_importance + right_importance;
+  // Negative signals that neither child contributes.
+  if (importance <= 0.0f) return -1.0f;
+  return left_importance / importance;
+}
+
+float LightTree::LightPDFValue(uint32_t light, const glm::vec3& point, const glm::vec3& direction) const {
+  return collidables_->Visit(lights_[light], [&](const auto& collidable) {
+    return collidable.PDFValue(point, direction);
+  });
+}
+
+}  // namespace rt
@@ -16,7 +16,8 @@ bool Dielectric::Scatter(const Ray& ray,
                          const Collision& collision,
                          glm::vec3& attenuation,
                          Ray& scattered,
-                         float& pdf) const {
+                         float& pdf,
+                         Sampler& sampler) const {
   attenuation = {1, 1, 1};
   const float refraction_ratio = collision.outside ? (1.0f / refraction_index_) : refraction_index_;
 
@@ -25,7 +26,7 @@ bool Dielectric::Scatter(const Ray& ray,
   const float sin_theta = sqrtf(1.0f - cos_theta * cos_theta);
 
   const bool can_refract =
-      refraction_ratio * sin_theta <= 1.0f && Reflectance(cos_theta, refraction_ratio) <= random::Float();
+      refraction_ratio * sin_theta <= 1.0f && Reflectance(cos_theta, refraction_ratio) <= sampler.Get1D();
   const glm::vec3 direction = can_refract ?
                               glm::refract(unit_direction, collision.normal, refraction_ratio) :
                               glm::reflect(unit_direction, collision.normal);
@@ -41,6 +42,10 @@ glm::vec3 Dielectric::Emit(const Ray& ray, const Collision& collision, float u,
   return {0, 0, 0};
 }
 
+bool Dielectric::IsSpecular() const {
+  return true;
+}
+
 float Dielectric::Reflectance(float cosine, float refraction_index) {
   // Schlick's approximation.
   float r0 = (1.0f - refraction_index) / (1.0f + refraction_index);
@@ -56,7 +61,8 @@ bool DiffuseLight::Scatter(const Ray& ray,
                            const Collision& collision,
                            glm::vec3& attenuation,
                            Ray& scattered,
-                           float& pdf) const {
+                           float& pdf,
+                           Sampler& sampler) const {
   return false;
 }
 
@@ -76,6 +82,23 @@ glm::vec3 DiffuseLight::Emit(const Ray& ray,
   }
 }
 
+bool DiffuseLight::IsSpecular() const {
+  return false;
+}
+
+glm::vec3 DiffuseLight::AverageEmission() const {
+  constexpr int32_t kResolution = 4;
+  glm::vec3 sum{0, 0, 0};
+  for (int32_t i = 0; i < kResolution; ++i) {
+    for (int32_t j = 0; j < kResolution; ++j) {
+      const float u = (static_cast<float>(i) + 0.5f) / static_cast<float>(kResolution);
+      const float v = (static_cast<float>(j) + 0.5f) / static_cast<float>(kResolution);
+      sum += std::visit([&](const auto& texture) { return texture.Sample(u, v, glm::vec3{u, v, 0.0f}); }, emit_);
+    }
+  }
+  return sum / static_cast<float>(kResolution * kResolution);
+}
+
 Isotropic::Isotropic(glm::vec3 albedo) : albedo_{SolidColorTexture{albedo}} {}
 
 Isotropic::Isotropic(texture_t albedo) : albedo_{std::move(albedo)} {}
@@ -84,31 +107,38 @@ bool Isotropic::Scatter(const Ray& ray,
                         const Collision& collision,
                         glm::vec3& attenuation,
                         Ray& scattered,
-                        float& pdf) const {
+                        float& pdf,
+                        Sampler& sampler) const {
   attenuation = std::visit([&](const auto& texture) {
     return texture.Sample(collision.u, collision.v, collision.point);
   }, albedo_);
-  scattered = Ray{collision.point, random::InUnitSphere(), ray.Time()};
+  scattered = Ray{collision.point, random::UnitVec3(sampler.Get2D()), ray.Time()};
+  pdf = 1.0f / (4.0f * std::numbers::pi_v<float>);
   return true;
 }
 
 float Isotropic::ScatteringPDF(const Ray& ray, const Collision& collision, const Ray& scattered) const {
-  return 0.0f;
+  return 1.0f / (4.0f * std::numbers::pi_v<float>);
 }
 
 glm::vec3 Isotropic::Emit(const Ray& ray, const Collision& collision, float u, float v, const glm::vec3& point) const {
   return {0, 0, 0};
 }
 
+bool Isotropic::IsSpecular() const {
+  return false;
+}
+
 Lambertian::Lambertian(texture_t albedo) : albedo_{std::move(albedo)} {}
 
 bool Lambertian::Scatter(const Ray& ray,
                          const Collision& collision,
                          glm::vec3& attenuation,
                          Ray& scattered,
-                         float& pdf) const {
+                         float& pdf,
+                         Sampler& sampler) const {
   const ONB onb{collision.normal};
-  const glm::vec3 scatter_direction = onb.Local(random::CosineDirection());
+  const glm::vec3 scatter_direction = onb.Local(random::CosineDirection(sampler.Get2D()));
   scattered = Ray{collision.point, glm::normalize(scatter_direction), ray.Time()};
   attenuation = std::visit([&](const auto& texture) {
     return texture.Sample(collision.u, collision.v, collision.point);
@@ -126,6 +156,10 @@ glm::vec3 Lambertian::Emit(const Ray& ray, const Collision& collision, float u,
   return {0, 0, 0};
 }
 
+bool Lambertian::IsSpecular() const {
+  return false;
+}
+
 Metal::Metal(glm::vec3 albedo, float fuzziness)
     : albedo_{albedo}, fuzziness_{fuzziness < 1.0f ? fuzziness : 1.0f} {}
 
@@ -133,9 +167,12 @@ bool Metal::Scatter(const Ray& ray,
                     const Collision& collision,
                     glm::vec3& attenuation,
                     Ray& scattered,
-                    float& pdf) const {
+                    float& pdf,
+                    Sampler& sampler) const {
   const glm::vec3 reflected = glm::reflect(glm::normalize(ray.Direction()), collision.normal);
-  scattered = Ray{collision.point, reflected + fuzziness_ * random::InUnitSphere(), ray.Time()};
+  const glm::vec2 u = sampler.Get2D();
+  const glm::vec3 fuzz = random::InUnitSphere({u, sampler.Get1D()});
+  scattered = Ray{collision.point, reflected + fuzziness_ * fuzz, ray.Time()};
   attenuation = albedo_;
   return glm::dot(scattered.Direction(), collision.normal) > 0;
 }
@@ -148,4 +185,9 @@ glm::vec3 Metal::Emit(const Ray& ray, const Collision& collision, float u, float
   return {0, 0, 0};
 }
 
+bool Metal::IsSpecular() const {
+  // Fuzzy reflections are not described by a density either.
+  return true;
+}
+
 }  // namespace rt
@@ -2,9 +2,10 @@
 
 namespace rt {
 ONB::ONB(const glm::vec3& w) : w{glm::normalize(w)} {
-  const glm::vec3 a = glm::abs(w.x) > 0.9f ? glm::vec3{0.0f, 1.0f, 0.0f} : glm::vec3{1.0f, 0.0f, 0.0f};
-  v = glm::normalize(glm::cross(w, a));
-  u = glm::cross(w, v);
+  // Use the normalized member, the parameter may be of any length.
+  const glm::vec3 a = glm::abs(this->w.x) > 0.9f ? glm::vec3{0.0f, 1.0f, 0.0f} : glm::vec3{1.0f, 0.0f, 0.0f};
+  v = glm::normalize(glm::cross(this->w, a));
+  u = glm::cross(this->w, v);
 }
 
 glm::vec3 ONB::Local(float a, float b, float c) const {
@@ -1,7 +1,6 @@
 #include "pdf.h"
 
 #include <numbers>
-#include <utility>
 #include <variant>
 
 #include "random.h"
@@ -14,19 +13,58 @@ float CosinePDF::Value(const glm::vec3& direction) const {
   return cosine <= 0.0f ? 0.0f : cosine / std::numbers::pi_v<float>;
 }
 
-glm::vec3 CosinePDF::Generate() const {
-  return onb_.Local(random::CosineDirection());
+glm::vec3 CosinePDF::Generate(Sampler& sampler) const {
+  return onb_.Local(random::CosineDirection(sampler.Get2D()));
 }
 
-CollidablePDF::CollidablePDF(collidable_t  collidable, const glm::vec3& origin)
-    : collidable_{std::move(collidable)}, origin_{origin} {}
+MaterialPDF::MaterialPDF(const Ray& ray, const Collision& collision) : ray_{ray}, collision_{&collision} {}
+
+float MaterialPDF::Value(const glm::vec3& direction) const {
+  const Ray scattered{collision_->point, direction, ray_.Time()};
+  return std::visit([&](const auto& material) {
+    return material.ScatteringPDF(ray_, *collision_, scattered);
+  }, *collision_->material);
+}
+
+glm::vec3 MaterialPDF::Generate(Sampler& sampler) const {
+  Ray scattered{};
+  glm::vec3 attenuation;
+  float pdf;
+  const bool is_scattered = std::visit([&](const auto& material) {
+    return material.Scatter(ray_, *collision_, attenuation, scattered, pdf, sampler);
+  }, *collision_->material);
+  return is_scattered ? scattered.Direction() : glm::vec3{0, 0, 0};
+}
+
+CollidablePDF::CollidablePDF(const collidable_pool_t& collidables,
+                             CollidableReference collidable,
+                             const glm::vec3& origin)
+    : collidables_{&collidables}, collidable_{collidable}, origin_{origin} {}
 
 float CollidablePDF::Value(const glm::vec3& direction) const {
-  return std::visit([&](const auto& collidable) { return collidable.PDFValue(origin_, direction); }, collidable_);
+  return collidables_->Visit(collidable_, [&](const auto& collidable) {
+    return collidable.PDFValue(origin_, direction);
+  });
+}
+
+glm::vec3 CollidablePDF::Generate(Sampler& sampler) const {
+  return collidables_->Visit(collidable_, [&](const auto& collidable) {
+    return collidable.RandomTowards(origin_, sampler);
+  });
+}
+
+LightPDF::LightPDF(const LightList& lights,
+                   LightSamplingStrategy strategy,
+                   const glm::vec3& origin,
+                   const glm::vec3& normal)
+    : lights_{&lights}, strategy_{strategy}, origin_{origin}, normal_{normal} {}
+
+float LightPDF::Value(const glm::vec3& direction) const {
+  return lights_->PDFValue(origin_, normal_, direction, strategy_);
 }
 
-glm::vec3 CollidablePDF::Generate() const {
-  return std::visit([&](const auto& collidable) { return collidable.RandomTowards(origin_); }, collidable_);
+glm::vec3 LightPDF::Generate(Sampler& sampler) const {
+  return lights_->RandomTowards(origin_, normal_, strategy_, sampler);
 }
 
 }  // namespace rt
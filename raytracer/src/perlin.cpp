@@ -3,16 +3,17 @@
 #include "random.h"
 
 namespace rt {
-Perlin::Perlin() {
+Perlin::Perlin(uint32_t seed) {
+  random::Generator generator{seed};
   for (uint32_t i = 0; i < kPointCount; ++i) {
-    random_vectors_[i] = random::Vec3(-1.0f, 1.0f);
+    random_vectors_[i] = random::Vec3(generator, -1.0f, 1.0f);
     permutation_x_[i] = i;
     permutation_y_[i] = i;
     permutation_z_[i] = i;
   }
-  Permute(permutation_x_);
-  Permute(permutation_y_);
-  Permute(permutation_z_);
+  Permute(permutation_x_, generator);
+  Permute(permutation_y_, generator);
+  Permute(permutation_z_, generator);
 }
 
 float Perlin::Noise(const glm::vec3& point) const {
@@ -43,10 +44,10 @@ float Perlin::Turbulence(glm::vec3 point, uint32_t depth) const {
   return fabs(accumulated);
 }
 
-void Perlin::Permute(std::array<uint32_t, kPointCount>& permutation) {
+void Perlin::Permute(std::array<uint32_t, kPointCount>& permutation, random::Generator& generator) {
   // TODO Use std for permutation?
   for (uint32_t i = kPointCount - 1; i > 0; --i) {
-    const uint32_t target = random::UInt32(0, i);
+    const uint32_t target = random::UInt32(generator, 0, i);
     std::swap(permutation[i], permutation[target]);
   }
 }
@@ -1,45 +1,70 @@
 #include "random.h"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <numbers>
-#include <random>
 
 namespace rt::random {
 
-uint32_t UInt32() {
-  static thread_local std::mt19937 generator{std::random_device{}()};
-  static std::uniform_int_distribution<uint32_t> distribution{0, 1};
-  return distribution(generator);
+Generator::Generator(uint64_t sequence, uint64_t seed) : increment_{(sequence << 1u) | 1u} {
+  UInt32();
+  state_ += seed;
+  UInt32();
 }
 
-uint32_t UInt32(uint32_t min, uint32_t max) {
-  static thread_local std::mt19937 generator{std::random_device{}()};
-  std::uniform_int_distribution<uint32_t> distribution{min, max};
-  return distribution(generator);
+uint32_t Generator::UInt32() {
+  constexpr uint64_t kMultiplier = 0x5851f42d4c957f2dULL;
+  const uint64_t state = state_;
+  state_ = state * kMultiplier + increment_;
+  const auto xor_shifted = static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+  const auto rotation = static_cast<uint32_t>(state >> 59u);
+  return (xor_shifted >> rotation) | (xor_shifted << ((~rotation + 1u) & 31u));
 }
 
-float Float() {
-  static thread_local std::mt19937 generator{std::random_device{}()};
-  static std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
-  return distribution(generator);
+uint64_t Hash(uint64_t a, uint64_t b) {
+  // SplitMix64 finalizer applied to both values in turn.
+  const auto mix = [](uint64_t value) {
+    value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27u)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31u);
+  };
+  return mix(mix(a + 0x9e3779b97f4a7c15ULL) ^ b);
 }
 
-float Float(float min, float max) {
-  static thread_local std::mt19937 generator{std::random_device{}()};
-  std::uniform_real_distribution<float> distribution(min, max);
-  return distribution(generator);
+uint64_t Hash(const glm::vec3& a, const glm::vec3& b) {
+  uint64_t hash = 0;
+  for (int32_t i = 0; i < 3; ++i) {
+    hash = Hash(hash, (static_cast<uint64_t>(std::bit_cast<uint32_t>(a[i])) << 32u) | std::bit_cast<uint32_t>(b[i]));
+  }
+  return hash;
+}
+
+uint32_t UInt32(Generator& generator, uint32_t min, uint32_t max) {
+  const uint64_t range = static_cast<uint64_t>(max) - min + 1u;
+  return min + static_cast<uint32_t>((generator.UInt32() * range) >> 32u);
+}
+
+float Float(Generator& generator) {
+  constexpr float kOneMinusEpsilon = 0x1.fffffep-1f;
+  return std::min(static_cast<float>(generator.UInt32() >> 8u) * 0x1p-24f, kOneMinusEpsilon);
 }
 
-glm::vec3 Vec3() {
-  return {Float(), Float(), Float()};
+float Float(Generator& generator, float min, float max) {
+  return min + (max - min) * Float(generator);
 }
 
-glm::vec3 Vec3(float min, float max) {
-  return {Float(min, max), Float(min, max), Float(min, max)};
+glm::vec3 Vec3(Generator& generator) {
+  return {Float(generator), Float(generator), Float(generator)};
 }
 
-glm::vec3 CosineDirection() {
-  const auto r1 = Float();
-  const auto r2 = Float();
+glm::vec3 Vec3(Generator& generator, float min, float max) {
+  return {Float(generator, min, max), Float(generator, min, max), Float(generator, min, max)};
+}
+
+glm::vec3 CosineDirection(const glm::vec2& u) {
+  const auto r1 = u.x;
+  const auto r2 = u.y;
   const auto z = glm::sqrt(1.0f - r2);
   const auto phi = 2.0f * std::numbers::pi_v<float> * r1;
   const auto x = glm::cos(phi) * glm::sqrt(r2);
@@ -47,29 +72,46 @@ glm::vec3 CosineDirection() {
   return {x, y, z};
 }
 
-glm::vec3 InUnitSphere() {
-  while (true) {
-    auto p = Vec3(-1.0f, 1.0f);
-    if (glm::dot(p, p) >= 1.0f) continue;
-    return p;
-  }
+glm::vec3 InUnitSphere(const glm::vec3& u) {
+  return UnitVec3({u.x, u.y}) * std::cbrt(u.z);
 }
 
-glm::vec3 InUnitDisk() {
-  while (true) {
-    auto p = glm::vec3{Float(-1.0f, 1.0f), Float(-1.0f, 1.0f), 0.0f};
-    if (glm::dot(p, p) >= 1.0f) continue;
-    return p;
+glm::vec3 InUnitDisk(const glm::vec2& u) {
+  // Shirley and Chiu's concentric mapping of the square onto the disk.
+  const glm::vec2 offset = 2.0f * u - 1.0f;
+  if (offset.x == 0.0f && offset.y == 0.0f) return {0.0f, 0.0f, 0.0f};
+  constexpr float kQuarterPi = std::numbers::pi_v<float> / 4.0f;
+  float radius, theta;
+  if (std::abs(offset.x) > std::abs(offset.y)) {
+    radius = offset.x;
+    theta = kQuarterPi * (offset.y / offset.x);
+  } else {
+    radius = offset.y;
+    theta = 2.0f * kQuarterPi - kQuarterPi * (offset.x / offset.y);
   }
+  return {radius * glm::cos(theta), radius * glm::sin(theta), 0.0f};
 }
 
-glm::vec3 InHemisphere(const glm::vec3& normal) {
-  const glm::vec3 in_unit_sphere = InUnitSphere();
+glm::vec3 InHemisphere(const glm::vec3& u, const glm::vec3& normal) {
+  const glm::vec3 in_unit_sphere = InUnitSphere(u);
   return glm::dot(in_unit_sphere, normal) > 0.0f ? in_unit_sphere : -in_unit_sphere;
 }
 
-glm::vec3 UnitVec3() {
-  return glm::normalize(InUnitSphere());
+glm::vec3 UnitVec3(const glm::vec2& u) {
+  const float z = 1.0f - 2.0f * u.x;
+  const float radius = glm::sqrt(std::max(0.0f, 1.0f - z * z));
+  const float phi = 2.0f * std::numbers::pi_v<float> * u.y;
+  return {radius * glm::cos(phi), radius * glm::sin(phi), z};
+}
+
+glm::vec3 ToSphere(const glm::vec2& u, float radius, float distance_squared) {
+  const float r1 = u.x;
+  const float r2 = u.y;
+  const float cos_theta_max = glm::sqrt(1.0f - radius * radius / distance_squared);
+  const float z = 1.0f + r2 * (cos_theta_max - 1.0f);
+  const float phi = 2.0f * std::numbers::pi_v<float> * r1;
+  const float sin_theta = glm::sqrt(1.0f - z * z);
+  return {glm::cos(phi) * sin_theta, glm::sin(phi) * sin_theta, z};
 }
 
 }  // namespace rt::random
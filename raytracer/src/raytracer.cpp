@@ -1,6 +1,7 @@
 #include "raytracer.h"
 
 #include <chrono>
+#include <stdexcept>
 
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
@@ -79,6 +80,7 @@ void Raytracer::RenderUISettings() {
     ImGui::BeginDisabled(is_rendering);
 
     ImGui::ListBox("Scene", &renderer_settings_.scene_type, kSceneNames, IM_ARRAYSIZE(kSceneNames), 6);
+    ImGui::InputFloat("Time (s)", &renderer_settings_.time, 0.1f, 1.0f, "%.2f");
 
     static bool use_preview_window_resolution = true;
     ImGui::Checkbox("Use Preview Window Resolution", &use_preview_window_resolution);
@@ -88,14 +90,43 @@ void Raytracer::RenderUISettings() {
     }
 
     ImGui::InputInt("Samples per Pixel", &renderer_settings_.samples_per_pixel, 10, 100);
+    ImGui::InputInt("Samples per Pass", &renderer_settings_.samples_per_pass, 1, 10);
+    const char* budget_names[RenderBudget::RenderBudgetCount] = {"Samples", "Time", "Noise"};
+    ImGui::SliderInt("Budget",
+                     &renderer_settings_.budget,
+                     0,
+                     RenderBudget::RenderBudgetCount - 1,
+                     budget_names[renderer_settings_.budget]);
+    if (renderer_settings_.budget == RenderBudget::TimeBudget) {
+      ImGui::InputFloat("Time Budget (s)", &renderer_settings_.time_budget_seconds, 1.0f, 10.0f, "%.1f");
+    } else if (renderer_settings_.budget == RenderBudget::NoiseBudget) {
+      ImGui::InputFloat("Noise Target", &renderer_settings_.noise_target, 0.001f, 0.01f, "%.4f");
+    }
+    ImGui::Checkbox("Adaptive Sampling", &renderer_settings_.adaptive_sampling);
+    ImGui::BeginDisabled(!renderer_settings_.adaptive_sampling);
+    ImGui::InputInt("Minimum Samples", &renderer_settings_.adaptive_min_samples, 1, 10);
+    ImGui::InputFloat("Error Threshold", &renderer_settings_.adaptive_error_threshold, 0.001f, 0.01f, "%.4f");
+    ImGui::EndDisabled();
+    const char* sampler_type_names[SamplerType::SamplerTypeCount] = {"Independent", "Stratified", "Halton", "Sobol"};
+    ImGui::SliderInt("Sampler",
+                     &renderer_settings_.sampler_type,
+                     0,
+                     SamplerType::SamplerTypeCount - 1,
+                     sampler_type_names[renderer_settings_.sampler_type]);
     ImGui::InputInt("Maximum Child Rays", &renderer_settings_.max_child_rays, 1, 10);
 
+    ImGui::Checkbox("Russian Roulette", &renderer_settings_.russian_roulette);
+    ImGui::BeginDisabled(!renderer_settings_.russian_roulette);
+    ImGui::InputInt("Russian Roulette Depth", &renderer_settings_.russian_roulette_depth, 1, 10);
+    ImGui::EndDisabled();
+
     ImGui::RadioButton("Chunk by Chunk", &renderer_settings_.mode, RenderMode::ChunkByChunk);
     ImGui::SameLine();
     ImGui::RadioButton("Row by Row", &renderer_settings_.mode, RenderMode::RowByRow);
 
     ImGui::BeginDisabled(renderer_settings_.mode != RenderMode::ChunkByChunk);
     ImGui::InputInt("Chunk Size", &renderer_settings_.chunk_size, 1, 10);
+    ImGui::Checkbox("Balance Chunk Costs", &renderer_settings_.balance_chunk_costs);
     ImGui::EndDisabled();
 
     ImGui::Separator();  // --------------------------------------------------
@@ -109,6 +140,25 @@ void Raytracer::RenderUISettings() {
                      BVHSplitStrategy::SplitStrategyCount - 1,
                      bvh_split_strategy_names[renderer_settings_.bvh_split_strategy]);
     ImGui::Separator();  // --------------------------------------------------
+    ImGui::Text("Light Sampling");
+
+    const char* light_sampling_strategy_names[LightSamplingStrategy::LightSamplingStrategyCount]
+        = {"Power Proportional", "Light BVH"};
+    ImGui::SliderInt("Light Selection",
+                     &renderer_settings_.light_sampling_strategy,
+                     0,
+                     LightSamplingStrategy::LightSamplingStrategyCount - 1,
+                     light_sampling_strategy_names[renderer_settings_.light_sampling_strategy]);
+    ImGui::Checkbox("Next Event Estimation", &renderer_settings_.next_event_estimation);
+
+    const char* mis_heuristic_names[MISHeuristic::MISHeuristicCount] = {"Balance", "Power"};
+    ImGui::SliderInt("MIS Heuristic",
+                     &renderer_settings_.mis_heuristic,
+                     0,
+                     MISHeuristic::MISHeuristicCount - 1,
+                     mis_heuristic_names[renderer_settings_.mis_heuristic]);
+    ImGui::SliderFloat("Light Sampling Weight", &renderer_settings_.light_sampling_weight, 0.0f, 1.0f);
+    ImGui::Separator();  // --------------------------------------------------
 
     if (ImGui::Button("Render")) {
       if (use_preview_window_resolution) {
@@ -118,9 +168,27 @@ void Raytracer::RenderUISettings() {
       OnRender();
     }
     ImGui::EndDisabled();
+    if (is_rendering) {
+      ImGui::SameLine();
+      if (ImGui::Button("Cancel")) {
+        renderer_.Cancel();
+      }
+    }
 
     const RendererStatistics statistics = renderer_.Statistics();
     ImGui::Text("Resolution: %d x %d", statistics.width, statistics.height);
+    ImGui::Text("Texture Memory: %.2f MB (%u images, %u noise)",
+                static_cast<double>(statistics.texture_memory.TotalBytes()) / (1024.0 * 1024.0),
+                statistics.texture_memory.image_count,
+                statistics.texture_memory.noise_count);
+    ImGui::Text("Average Samples per Pixel: %.1f (%d passes)",
+                statistics.average_samples_per_pixel,
+                statistics.passes);
+    ImGui::Text("Estimated Error: %.4f", statistics.estimated_error);
+    if (statistics.cancelled) {
+      ImGui::Text("Cancelled");
+    }
+    ImGui::Checkbox("Show Sample Counts", &show_sample_counts_);
     if (statistics.render_time_ms != std::chrono::milliseconds::zero()) {
       using namespace std::chrono;
       auto ms = statistics.render_time_ms;
@@ -129,11 +197,19 @@ void Raytracer::RenderUISettings() {
       auto m = duration_cast<minutes>(s);
       s -= duration_cast<seconds>(m);
       ImGui::Text("Rendering Time: %d min %lld s %lld ms", m.count(), s.count(), ms.count());
+      ImGui::Text("Scene Preparation Time: %lld ms", statistics.scene_time_ms.count());
 
       if (ImGui::Button("Save to Disk")) {
-        auto render_result = renderer_.Result();
         const std::filesystem::path path{"result.png"};
-        utils::png::Encode(path, *render_result);
+        try {
+          utils::png::Encode(path, renderer_.Result());
+          save_error_.clear();
+        } catch (const std::runtime_error& error) {
+          save_error_ = error.what();
+        }
+      }
+      if (!save_error_.empty()) {
+        ImGui::Text("%s", save_error_.c_str());
       }
     }
 
@@ -146,7 +222,7 @@ void Raytracer::RenderPreview() {
   ImGui::Begin("Result");
   viewport_width_ = static_cast<int32_t>(ImGui::GetContentRegionAvail().x);
   viewport_height_ = static_cast<int32_t>(ImGui::GetContentRegionAvail().y);
-  auto render_result = renderer_.Result();
+  Image* render_result = show_sample_counts_ ? sample_count_map_.get() : preview_.get();
   if (render_result) {
     render_result->Update();
     ImGui::Image(reinterpret_cast<ImTextureID>(render_result->Texture()),
@@ -159,6 +235,13 @@ void Raytracer::RenderPreview() {
 
 void Raytracer::OnRender() {
   renderer_.OnResize(renderer_settings_.width, renderer_settings_.height);
+  if (preview_) {
+    preview_->Resize();
+    sample_count_map_->Resize();
+  } else {
+    preview_ = std::make_unique<Image>(renderer_.Result());
+    sample_count_map_ = std::make_unique<Image>(renderer_.SampleCountMap());
+  }
   renderer_.Render(renderer_settings_);
 }
 }  // namespace rt
@@ -1,8 +1,9 @@
 #include "rectangle.h"
 
+#include <limits>
 #include <utility>
 
-#include "random.h"
+#include "sampler.h"
 
 namespace rt {
 RectangleXY::RectangleXY(glm::vec2 x, glm::vec2 y, float z, material_t material)
@@ -14,8 +15,8 @@ bool RectangleXY::Collide(const Ray& ray, float t_min, float t_max, Collision& c
   const auto plane_point = ray.Origin() + t * ray.Direction();
   if (plane_point.x < x_[0] || x_[1] < plane_point.x || plane_point.y < y_[0] || y_[1] < plane_point.y) return false;
   collision.point = ray.At(t);
-  collision.u = (plane_point.x - x_[0]) / (x_[1], x_[0]);
-  collision.v = (plane_point.y - y_[0]) / (y_[1], y_[0]);
+  collision.u = (plane_point.x - x_[0]) / (x_[1] - x_[0]);
+  collision.v = (plane_point.y - y_[0]) / (y_[1] - y_[0]);
   collision.t = t;
   const glm::vec3 outward_normal{0, 0, 1};
   collision.SetNormal(ray, outward_normal);
@@ -32,14 +33,30 @@ glm::vec3 RectangleXY::Centroid() const {
   return (glm::vec3{x_[0], y_[0], z_} + glm::vec3{x_[1], y_[1], z_}) / 2.0f;
 }
 
+float RectangleXY::Area() const {
+  return (x_[1] - x_[0]) * (y_[1] - y_[0]);
+}
+
+const material_t* RectangleXY::GetMaterial() const {
+  return &material_;
+}
+
+DirectionCone RectangleXY::NormalBounds() const {
+  return {glm::vec3{0.0f, 0.0f, 1.0f}, 1.0f};
+}
+
 float RectangleXY::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  Collision collision;
+  if (!Collide(Ray{origin, direction}, 0.001f, std::numeric_limits<float>::max(), collision)) return 0.0f;
+  const float distance_squared = collision.t * collision.t * glm::dot(direction, direction);
+  const float cosine = glm::abs(glm::dot(direction, collision.normal) / glm::length(direction));
+  return distance_squared / (cosine * Area());
 }
 
-glm::vec3 RectangleXY::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 RectangleXY::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  const glm::vec2 u = sampler.Get2D();
+  const glm::vec3 random_point{glm::mix(x_[0], x_[1], u.x), glm::mix(y_[0], y_[1], u.y), z_};
+  return random_point - origin;
 }
 
 RectangleXZ::RectangleXZ(glm::vec2 x, glm::vec2 z, float y, material_t material)
@@ -69,17 +86,29 @@ glm::vec3 RectangleXZ::Centroid() const {
   return (glm::vec3{x_[0], z_[0], y_} + glm::vec3{x_[1], z_[1], y_}) / 2.0f;
 }
 
+float RectangleXZ::Area() const {
+  return (x_[1] - x_[0]) * (z_[1] - z_[0]);
+}
+
+const material_t* RectangleXZ::GetMaterial() const {
+  return &material_;
+}
+
+DirectionCone RectangleXZ::NormalBounds() const {
+  return {glm::vec3{0.0f, 1.0f, 0.0f}, 1.0f};
+}
+
 float RectangleXZ::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
   Collision collision;
   if (!Collide(Ray{origin, direction}, 0.001f, std::numeric_limits<float>::max(), collision)) return 0.0f;
-  const float area = (x_[1] - x_[0]) * (z_[1] - z_[0]);
   const float distance_squared = collision.t * collision.t * glm::dot(direction, direction);
   const float cosine = glm::abs(glm::dot(direction, collision.normal) / glm::length(direction));
-  return distance_squared / (cosine * area);
+  return distance_squared / (cosine * Area());
 }
 
-glm::vec3 RectangleXZ::RandomTowards(const glm::vec3& origin) const {
-  const glm::vec3 random_point{random::Float(x_[0], x_[1]), y_, random::Float(z_[0], z_[1])};
+glm::vec3 RectangleXZ::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  const glm::vec2 u = sampler.Get2D();
+  const glm::vec3 random_point{glm::mix(x_[0], x_[1], u.x), y_, glm::mix(z_[0], z_[1], u.y)};
   return random_point - origin;
 }
 
@@ -110,14 +139,30 @@ glm::vec3 RectangleYZ::Centroid() const {
   return (glm::vec3{y_[0], z_[0], x_} + glm::vec3{y_[1], z_[1], x_}) / 2.0f;
 }
 
+float RectangleYZ::Area() const {
+  return (y_[1] - y_[0]) * (z_[1] - z_[0]);
+}
+
+const material_t* RectangleYZ::GetMaterial() const {
+  return &material_;
+}
+
+DirectionCone RectangleYZ::NormalBounds() const {
+  return {glm::vec3{1.0f, 0.0f, 0.0f}, 1.0f};
+}
+
 float RectangleYZ::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  Collision collision;
+  if (!Collide(Ray{origin, direction}, 0.001f, std::numeric_limits<float>::max(), collision)) return 0.0f;
+  const float distance_squared = collision.t * collision.t * glm::dot(direction, direction);
+  const float cosine = glm::abs(glm::dot(direction, collision.normal) / glm::length(direction));
+  return distance_squared / (cosine * Area());
 }
 
-glm::vec3 RectangleYZ::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 RectangleYZ::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  const glm::vec2 u = sampler.Get2D();
+  const glm::vec3 random_point{x_, glm::mix(y_[0], y_[1], u.x), glm::mix(z_[0], z_[1], u.y)};
+  return random_point - origin;
 }
 
 }  // namespace rt
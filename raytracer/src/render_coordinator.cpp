@@ -0,0 +1,180 @@
+#include "render_coordinator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <poll.h>
+
+#include "tile_scheduler.h"
+
+namespace rt {
+namespace {
+constexpr int kPollIntervalMs = 100;
+constexpr std::chrono::seconds kHandshakeTimeout{5};
+}  // namespace
+
+RenderCoordinator::RenderCoordinator(const std::string& address,
+                                     std::chrono::milliseconds worker_timeout,
+                                     int32_t tile_size)
+    : listener_{Socket::Listen(address)}, worker_timeout_{worker_timeout}, tile_size_{std::max(tile_size, 1)} {}
+
+RendererStatistics RenderCoordinator::Render(const RenderJob& job, std::stop_token stop_token) {
+  using namespace std::chrono;
+  const auto start_time = high_resolution_clock::now();
+  const RendererSettings& settings = job.settings;
+  if (settings.budget != RenderBudget::SampleBudget) {
+    // Workers stop each tile on its own, there is no rule yet to end the whole image on time or noise.
+    throw std::invalid_argument{"Distributed renders only support the samples per pixel budget."};
+  }
+  if (settings.width != framebuffer_.Width() || settings.height != framebuffer_.Height()) {
+    framebuffer_.Resize(settings.width, settings.height);
+  }
+  const Tile image{{0, settings.height}, {0, settings.width}};
+  const std::vector<Tile> tiles = TileScheduler::ChunkTiles(image, tile_size_);
+  Progress progress{job, {tiles.begin(), tiles.end()}, tiles.size()};
+  progress.statistics.width = settings.width;
+  progress.statistics.height = settings.height;
+  for (Worker& worker : workers_) worker.has_settings = false;
+
+  // A connection which does not greet soon is not a worker, and must not hold up the ones which are.
+  const milliseconds handshake_timeout = std::min(worker_timeout_, duration_cast<milliseconds>(kHandshakeTimeout));
+  auto last_worker_time = steady_clock::now();
+  while (progress.remaining_tiles > 0 && !stop_token.stop_requested()) {
+    const auto now = steady_clock::now();
+    for (Worker& worker : workers_) {
+      if (!worker.greeted) {
+        if (now - worker.connect_time > handshake_timeout) worker.socket.Close();
+        continue;
+      }
+      if (worker.tile && now - worker.tile_start_time > worker_timeout_) DropWorker(worker, progress.pending_tiles);
+      if (!worker.socket.Valid() || worker.tile || progress.pending_tiles.empty()) continue;
+      if (!worker.has_settings) {
+        worker.has_settings = protocol::SendMessage(worker.socket, protocol::MessageType::Settings, settings);
+        if (!worker.has_settings) {
+          DropWorker(worker, progress.pending_tiles);
+          continue;
+        }
+      }
+      worker.tile = progress.pending_tiles.front();
+      worker.tile_start_time = now;
+      progress.pending_tiles.pop_front();
+      if (!protocol::SendMessage(worker.socket, protocol::MessageType::RenderTile, *worker.tile)) {
+        DropWorker(worker, progress.pending_tiles);
+      }
+    }
+    std::erase_if(workers_, [](const Worker& worker) { return !worker.socket.Valid(); });
+    if (std::ranges::any_of(workers_, &Worker::greeted)) {
+      last_worker_time = now;
+    } else if (now - last_worker_time > worker_timeout_) {
+      throw std::runtime_error{"No worker connected within the timeout."};
+    }
+
+    std::vector<pollfd> descriptors{{listener_.Fd(), POLLIN, 0}};
+    for (const Worker& worker : workers_) descriptors.push_back({worker.socket.Fd(), POLLIN, 0});
+    if (poll(descriptors.data(), descriptors.size(), kPollIntervalMs) <= 0) continue;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      if (descriptors[i + 1].revents != 0 && !Receive(workers_[i], progress)) {
+        DropWorker(workers_[i], progress.pending_tiles);
+      }
+    }
+    if (descriptors[0].revents & POLLIN) AcceptWorkers();
+  }
+
+  RendererStatistics& statistics = progress.statistics;
+  const auto pixels = static_cast<double>(std::max(settings.width * settings.height, 1));
+  statistics.average_samples_per_pixel = static_cast<float>(static_cast<double>(progress.samples) / pixels);
+  statistics.estimated_error = static_cast<float>(std::sqrt(progress.squared_error / pixels));
+  statistics.cancelled = progress.remaining_tiles > 0;
+  statistics.render_time_ms = duration_cast<milliseconds>(high_resolution_clock::now() - start_time);
+  for (const FramebufferSink& sink : job.sinks) {
+    if (sink.on_finish) sink.on_finish(statistics);
+  }
+  return statistics;
+}
+
+Framebuffer& RenderCoordinator::Result() {
+  return framebuffer_;
+}
+
+size_t RenderCoordinator::WorkerCount() const {
+  return std::ranges::count_if(workers_, &Worker::greeted);
+}
+
+void RenderCoordinator::AcceptWorkers() {
+  for (Socket socket = listener_.Accept(); socket.Valid(); socket = listener_.Accept()) {
+    workers_.push_back({std::move(socket), std::chrono::steady_clock::now()});
+  }
+}
+
+void RenderCoordinator::DropWorker(Worker& worker, std::deque<Tile>& pending_tiles) {
+  if (worker.tile) pending_tiles.push_front(*worker.tile);
+  worker.tile.reset();
+  worker.socket.Close();
+}
+
+bool RenderCoordinator::Receive(Worker& worker, Progress& progress) {
+  constexpr size_t kHeaderSize = sizeof(protocol::MessageHeader);
+  while (true) {
+    size_t message_size = kHeaderSize;
+    if (worker.message.size() >= kHeaderSize) {
+      protocol::MessageHeader header;
+      std::memcpy(&header, worker.message.data(), kHeaderSize);
+      // Checked before the payload arrives, so a worker cannot make the coordinator buffer more than a tile.
+      if (!Expects(worker, header)) return false;
+      message_size += header.size;
+      if (worker.message.size() == message_size) {
+        const uint8_t* payload = worker.message.data() + kHeaderSize;
+        if (header.type == protocol::MessageType::Hello) {
+          protocol::HelloMessage hello;
+          std::memcpy(&hello, payload, sizeof(hello));
+          if (!hello.Compatible()) return false;
+          worker.greeted = true;
+        } else {
+          protocol::TileResultMessage result;
+          std::memcpy(&result, payload, sizeof(result));
+          if (result.tile.rows != worker.tile->rows || result.tile.columns != worker.tile->columns) return false;
+          MergeTile(worker, result, payload + sizeof(result), progress);
+        }
+        worker.message.clear();
+        continue;
+      }
+    }
+
+    const size_t received_size = worker.message.size();
+    worker.message.resize(message_size);
+    const ptrdiff_t received =
+        worker.socket.ReceiveAvailable(worker.message.data() + received_size, message_size - received_size);
+    worker.message.resize(received_size + static_cast<size_t>(std::max<ptrdiff_t>(received, 0)));
+    if (received <= 0) return received == 0;
+  }
+}
+
+bool RenderCoordinator::Expects(const Worker& worker, const protocol::MessageHeader& header) {
+  if (!worker.greeted) {
+    return header.type == protocol::MessageType::Hello && header.size == sizeof(protocol::HelloMessage);
+  }
+  return worker.tile && header.type == protocol::MessageType::TileResult
+      && header.size == sizeof(protocol::TileResultMessage) + worker.tile->Area() * sizeof(uint32_t);
+}
+
+void RenderCoordinator::MergeTile(Worker& worker,
+                                  const protocol::TileResultMessage& result,
+                                  const uint8_t* pixels,
+                                  Progress& progress) {
+  const Tile tile = *worker.tile;
+  std::vector<uint32_t> tile_pixels(tile.Area());
+  std::memcpy(tile_pixels.data(), pixels, tile_pixels.size() * sizeof(uint32_t));
+  framebuffer_.Publish(tile, tile_pixels.data());
+  for (const FramebufferSink& sink : progress.job.sinks) {
+    if (sink.on_tile) sink.on_tile(tile, tile_pixels.data());
+  }
+  progress.statistics.passes = std::max(progress.statistics.passes, result.passes);
+  progress.samples += result.samples;
+  progress.squared_error += result.squared_error;
+  --progress.remaining_tiles;
+  worker.tile.reset();
+}
+}  // namespace rt
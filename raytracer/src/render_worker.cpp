@@ -0,0 +1,90 @@
+#include "render_worker.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "framebuffer_sink.h"
+#include "render_protocol.h"
+
+namespace rt {
+namespace {
+constexpr std::chrono::milliseconds kConnectRetryInterval{100};
+}  // namespace
+
+RenderWorker::RenderWorker(std::string address, uint32_t thread_count)
+    : address_{std::move(address)}, renderer_{thread_count} {}
+
+void RenderWorker::Run(std::chrono::milliseconds connect_timeout, int32_t tile_limit) {
+  const Socket socket = Connect(connect_timeout);
+  if (!protocol::SendMessage(socket, protocol::MessageType::Hello, protocol::HelloMessage{})) return;
+
+  protocol::MessageHeader header;
+  int32_t tiles_rendered = 0;
+  while (socket.Receive(&header, sizeof(header))) {
+    switch (header.type) {
+      case protocol::MessageType::Settings: {
+        if (!protocol::ReceivePayload(socket, header, settings_)) return;
+      }
+        break;
+      case protocol::MessageType::RenderTile: {
+        Tile tile;
+        if (!protocol::ReceivePayload(socket, header, tile) || tiles_rendered++ == tile_limit) return;
+        if (!RenderTile(socket, tile)) return;
+      }
+        break;
+      default:
+        throw std::runtime_error{"Unknown message from the coordinator."};
+    }
+  }
+}
+
+Socket RenderWorker::Connect(std::chrono::milliseconds timeout) const {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    try {
+      return Socket::Connect(address_);
+    } catch (const std::runtime_error&) {
+      // The coordinator may not listen yet when workers are started along with it.
+      if (std::chrono::steady_clock::now() + kConnectRetryInterval > deadline) throw;
+      std::this_thread::sleep_for(kConnectRetryInterval);
+    }
+  }
+}
+
+bool RenderWorker::RenderTile(const Socket& socket, const Tile& tile) {
+  const Tile image{{0, settings_.height}, {0, settings_.width}};
+  if (tile.Empty() || tile.Intersection(image).Area() != tile.Area()) return false;
+  RendererSettings settings = settings_;
+  settings.region = tile;
+  std::vector<uint32_t> pixels(tile.Area(), 0);
+  FramebufferSink sink{
+      .on_tile = [&](const Tile& part, const uint32_t* part_pixels) {
+        for (int32_t row = part.rows[0]; row < part.rows[1]; ++row) {
+          std::copy_n(part_pixels + (row - part.rows[0]) * part.Width(),
+                      part.Width(),
+                      pixels.begin() + (row - tile.rows[0]) * tile.Width() + (part.columns[0] - tile.columns[0]));
+        }
+      },
+  };
+  renderer_.Render(std::vector<RenderJob>{{settings, {std::move(sink)}}});
+  renderer_.Wait();
+
+  const RendererStatistics statistics = renderer_.Statistics();
+  const std::vector<uint32_t>& sample_counts = renderer_.SampleCounts();
+  protocol::TileResultMessage result{tile, statistics.passes};
+  for (int32_t row = tile.rows[0]; row < tile.rows[1]; ++row) {
+    for (int32_t column = tile.columns[0]; column < tile.columns[1]; ++column) {
+      result.samples += sample_counts[row * settings.width + column];
+    }
+  }
+  result.squared_error = static_cast<double>(statistics.estimated_error) * statistics.estimated_error * tile.Area();
+  return protocol::SendMessage(socket,
+                               protocol::MessageType::TileResult,
+                               result,
+                               pixels.data(),
+                               static_cast<uint32_t>(pixels.size() * sizeof(uint32_t)));
+}
+}  // namespace rt
@@ -1,8 +1,13 @@
 #include "renderer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <future>
 #include <limits>
 #include <random>
 #include <stdexcept>
+#include <utility>
 #include <variant>
 
 #include "pdf.h"
@@ -10,73 +15,106 @@
 #include "utils.h"
 
 namespace rt {
+Renderer::Renderer(uint32_t thread_count) : pool_{std::max(thread_count, 1U)} {}
+
 void Renderer::OnResize(int32_t width, int32_t height) {
   if (state_ == RenderState::Running) return;
-  image_data_.clear();
-  image_data_.resize(width * height);
-  if (preview_) {
-    preview_->Resize(width, height, image_data_.data());
-  } else {
-    preview_ = std::make_shared<Image>(width, height, image_data_.data());
-  }
+  Resize(width, height);
+}
+
+Renderer::~Renderer() {
+  // The render thread uses the pool, it has to stop before the members are destroyed.
+  Cancel();
+  Join();
 }
 
 void Renderer::Render(const RendererSettings& settings) {
-  settings_ = settings;
-
-  auto render_task = [&]() {
-    using namespace std::chrono;
-    scene_ = std::make_shared<Scene>(static_cast<SceneType>(settings_.scene_type),
-                                     preview_->AspectRatio(),
-                                     static_cast<BVHSplitStrategy>(settings_.bvh_split_strategy));
-
-    state_ = RenderState::Running;
-    statistics_.render_time_ms = std::chrono::milliseconds::zero();
-    statistics_.width = preview_->Width();
-    statistics_.height = preview_->Height();
-    auto start_time = high_resolution_clock::now();
-
-    switch (settings_.mode) {
-      case RenderMode::RowByRow: {
-        for (int32_t row = 0; row < preview_->Height(); ++row) {
-          pool_.push_task(&Renderer::RenderRow, this, row);
-        }
+  Render(std::vector<RenderJob>{{settings, {}}});
+}
+
+void Renderer::Render(std::vector<RenderJob> jobs) {
+  Join();
+  error_ = nullptr;
+  state_ = RenderState::Running;
+
+  auto render_task = [this, jobs = std::move(jobs)](std::stop_token stop_token) {
+    stop_token_ = stop_token;
+    // While a job renders, the scene of the next one is prepared and the sinks of the previous one finish, so frames of
+    // a sequence overlap their scene updates and encoding with rendering.
+    int32_t width = width_, height = height_;
+    auto prepare_scene = [&](const RendererSettings& settings, std::shared_ptr<Scene> rendering) {
+      if (settings.width > 0 && settings.height > 0) {
+        width = settings.width;
+        height = settings.height;
       }
-        break;
-      case RenderMode::ChunkByChunk: {
-        const auto kHorizontalChunks =
-            static_cast<int32_t>(std::ceil(
-                static_cast<float>(preview_->Width()) / static_cast<float>(settings_.chunk_size)));
-        const auto kVerticalChunks =
-            static_cast<int32_t>(std::ceil(
-                static_cast<float>(preview_->Height()) / static_cast<float>(settings_.chunk_size)));
-        for (int32_t v_chunk = 1; v_chunk <= kVerticalChunks; ++v_chunk) {
-          for (int32_t h_chunk = 1; h_chunk <= kHorizontalChunks; ++h_chunk) {
-            glm::i32vec2 rows{(v_chunk - 1) * settings_.chunk_size,
-                              std::min(v_chunk * settings_.chunk_size, preview_->Height())};
-            glm::i32vec2 columns{(h_chunk - 1) * settings_.chunk_size,
-                                 std::min(h_chunk * settings_.chunk_size, preview_->Width())};
-            pool_.push_task(&Renderer::RenderChuck, this, rows, columns);
+      const float aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
+      return std::async(std::launch::async, [this, settings, aspect_ratio, rendering = std::move(rendering)] {
+        return PrepareScene(settings, aspect_ratio, rendering);
+      });
+    };
+    try {
+      std::future<PreparedScene> next_scene;
+      std::future<void> finishing;
+      if (!jobs.empty()) next_scene = prepare_scene(jobs.front().settings, nullptr);
+      for (size_t i = 0; i < jobs.size() && !stop_token.stop_requested(); ++i) {
+        const PreparedScene prepared = next_scene.get();
+        if (i + 1 < jobs.size()) next_scene = prepare_scene(jobs[i + 1].settings, prepared.scene);
+        RunJob(jobs[i], prepared);
+
+        std::vector<FramebufferSink> sinks = sinks_;
+        sinks.insert(sinks.end(), jobs[i].sinks.begin(), jobs[i].sinks.end());
+        if (finishing.valid()) finishing.get();
+        finishing = std::async(std::launch::async, [sinks = std::move(sinks), statistics = statistics_] {
+          for (const FramebufferSink& sink : sinks) {
+            if (sink.on_finish) sink.on_finish(statistics);
           }
-        }
+        });
       }
-        break;
-      default:
-        throw std::runtime_error{"Unknown rendering mode"};
+      if (next_scene.valid()) next_scene.wait();
+      if (finishing.valid()) finishing.get();
+    } catch (...) {
+      // The batch stops at the first error of a scene or sink, Wait() rethrows it.
+      error_ = std::current_exception();
     }
-
-    pool_.wait_for_tasks();
-    auto end_time = high_resolution_clock::now();
     state_ = RenderState::Stopped;
-    statistics_.render_time_ms = duration_cast<milliseconds>(end_time - start_time);
   };
 
-  main_render_thread_ = std::thread{render_task};
-  main_render_thread_.detach();
+  main_render_thread_ = std::jthread{render_task};
+}
+
+void Renderer::Cancel() {
+  main_render_thread_.request_stop();
+}
+
+void Renderer::Wait() {
+  Join();
+  if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+void Renderer::Join() {
+  if (main_render_thread_.joinable()) main_render_thread_.join();
+}
+
+void Renderer::AddSink(FramebufferSink sink) {
+  if (state_ == RenderState::Running) return;
+  sinks_.push_back(std::move(sink));
+}
+
+void Renderer::ClearSinks() {
+  if (state_ == RenderState::Running) return;
+  sinks_.clear();
+}
+
+Framebuffer& Renderer::Result() {
+  return framebuffer_;
+}
+
+Framebuffer& Renderer::SampleCountMap() {
+  return sample_count_map_;
 }
 
-std::shared_ptr<Image> Renderer::Result() const {
-  return preview_;
+const std::vector<uint32_t>& Renderer::SampleCounts() const {
+  return sample_counts_;
 }
 
 Renderer::RenderState Renderer::State() const {
@@ -87,45 +125,272 @@ RendererStatistics Renderer::Statistics() const {
   return statistics_;
 }
 
-void Renderer::RenderRow(int32_t row) {
-  for (int32_t column = 0; column < preview_->Width(); ++column) {
-    glm::vec4 color{};
-    for (int32_t sample = 1; sample <= settings_.samples_per_pixel; ++sample) {
-      glm::vec2 coordinate{
-          (static_cast<float>(column) + random::Float()) / static_cast<float>(preview_->Width()),
-          (static_cast<float>(row) + random::Float()) / static_cast<float>(preview_->Height())
-      };
-      const Ray ray = scene_->GetCamera()->ShootRay(coordinate);
-      color += RenderPixel(ray, settings_.max_child_rays);
+void Renderer::Resize(int32_t width, int32_t height) {
+  width_ = width;
+  height_ = height;
+  framebuffer_.Resize(width, height);
+  sample_count_map_.Resize(width, height);
+  sample_counts_.clear();
+  sample_counts_.resize(width * height);
+  accumulation_.clear();
+  accumulation_.resize(width * height);
+}
+
+void Renderer::RunJob(const RenderJob& job, const PreparedScene& prepared) {
+  using namespace std::chrono;
+  settings_ = job.settings;
+  job_sinks_ = job.sinks;
+  if (settings_.width > 0 && settings_.height > 0 && (settings_.width != width_ || settings_.height != height_)) {
+    Resize(settings_.width, settings_.height);
+  }
+  scene_ = prepared.scene;
+  statistics_.scene_time_ms = prepared.time_ms;
+
+  statistics_.render_time_ms = std::chrono::milliseconds::zero();
+  statistics_.cancelled = false;
+  statistics_.width = width_;
+  statistics_.height = height_;
+  statistics_.texture_memory = scene_->Textures().MemoryUsage();
+  auto start_time = high_resolution_clock::now();
+
+  // Only the region is reset and iterated, the pixels outside of it keep what earlier renders left.
+  const Tile region = Region();
+  for (int32_t row = region.rows[0]; row < region.rows[1]; ++row) {
+    const int32_t first_pixel = row * width_ + region.columns[0];
+    std::fill_n(accumulation_.begin() + first_pixel, region.Width(), PixelAccumulator{});
+    std::fill_n(sample_counts_.begin() + first_pixel, region.Width(), 0);
+  }
+  tile_costs_.Reset(region);
+  statistics_.passes = 0;
+  const auto budget = static_cast<RenderBudget>(settings_.budget);
+  const duration<float> time_budget{settings_.time_budget_seconds};
+  const int32_t samples_per_pass = std::max(settings_.samples_per_pass, 1);
+  auto pass_start_time = start_time;
+  for (int32_t samples = 0; samples < settings_.samples_per_pixel; samples += samples_per_pass) {
+    if (stop_token_.stop_requested()) break;
+    RenderPass();
+    ++statistics_.passes;
+    const bool errors_estimated = UpdateSampleStatistics();
+    ForEachSink([&](const FramebufferSink& sink) {
+      if (sink.on_pass) sink.on_pass(statistics_);
+    });
+    bool converged = true;
+    for (int32_t row = region.rows[0]; row < region.rows[1] && converged; ++row) {
+      const auto first_pixel = accumulation_.begin() + row * width_ + region.columns[0];
+      converged = std::all_of(first_pixel, first_pixel + region.Width(), [](const PixelAccumulator& pixel) {
+        return pixel.converged;
+      });
+    }
+    if (converged) break;
+
+    const auto pass_end_time = high_resolution_clock::now();
+    // The next pass is expected to last as long as this one, stopping early keeps the render within the budget.
+    if (budget == RenderBudget::TimeBudget
+        && (pass_end_time - start_time) + (pass_end_time - pass_start_time) > time_budget) {
+      break;
+    }
+    // Pixels without an error estimate yet count as zero error, the noise budget has to wait for them.
+    if (budget == RenderBudget::NoiseBudget && errors_estimated
+        && statistics_.estimated_error <= settings_.noise_target) {
+      break;
+    }
+    pass_start_time = pass_end_time;
+  }
+  auto end_time = high_resolution_clock::now();
+  statistics_.cancelled = stop_token_.stop_requested();
+  statistics_.render_time_ms = duration_cast<milliseconds>(end_time - start_time);
+}
+
+Tile Renderer::Region() const {
+  const Tile image{{0, height_}, {0, width_}};
+  return settings_.region.Empty() ? image : settings_.region.Intersection(image);
+}
+
+int32_t Renderer::ChunkSize(const Tile& region) const {
+  // Small regions, such as the tiles of a distributed render, are cut finer so that every thread gets chunks.
+  constexpr int32_t kMinChunkSize = 8;
+  constexpr double kChunksPerThread = 4.0;
+  const double chunks = kChunksPerThread * static_cast<double>(std::max<size_t>(pool_.get_thread_count(), 1));
+  const auto fitting_chunk_size = static_cast<int32_t>(std::sqrt(static_cast<double>(region.Area()) / chunks));
+  const int32_t chunk_size = std::max(settings_.chunk_size, 1);
+  return std::clamp(fitting_chunk_size, std::min(kMinChunkSize, chunk_size), chunk_size);
+}
+
+Renderer::PreparedScene Renderer::PrepareScene(const RendererSettings& settings,
+                                               float aspect_ratio,
+                                               const std::shared_ptr<Scene>& rendering) {
+  using namespace std::chrono;
+  const auto start_time = high_resolution_clock::now();
+  const auto scene_type = static_cast<SceneType>(settings.scene_type);
+  const auto bvh_split_strategy = static_cast<BVHSplitStrategy>(settings.bvh_split_strategy);
+  auto is_prepared = [&](const Scene& scene) {
+    return scene.Type() == scene_type && scene.SplitStrategy() == bvh_split_strategy
+        && scene.AspectRatio() == aspect_ratio && scene.Time() == settings.time;
+  };
+  // The rendering scene is only read, it can be shared as it is but not updated.
+  if (rendering && is_prepared(*rendering)) return {rendering, milliseconds::zero()};
+
+  std::shared_ptr<Scene> scene;
+  const auto cached = std::find_if(scenes_.begin(), scenes_.end(), [&](const std::shared_ptr<Scene>& candidate) {
+    return candidate->Type() == scene_type && candidate != rendering;
+  });
+  if (cached != scenes_.end()) {
+    scene = *cached;
+    scene->SetAspectRatio(aspect_ratio);
+    scene->SetTime(settings.time);
+    scene->SetSplitStrategy(bvh_split_strategy);
+  } else {
+    scene = scenes_.emplace_back(std::make_shared<Scene>(scene_type, aspect_ratio, bvh_split_strategy));
+    scene->SetTime(settings.time);
+  }
+  return {scene, duration_cast<milliseconds>(high_resolution_clock::now() - start_time)};
+}
+
+void Renderer::RenderPass() {
+  const Tile region = Region();
+  std::vector<Tile> tiles;
+  switch (settings_.mode) {
+    case RenderMode::RowByRow: {
+      tiles = TileScheduler::RowTiles(region);
+    }
+      break;
+    case RenderMode::ChunkByChunk: {
+      tiles = TileScheduler::ChunkTiles(region, ChunkSize(region));
+      if (settings_.balance_chunk_costs && statistics_.passes > 0) {
+        tiles = tile_costs_.BalancedTiles(static_cast<int32_t>(tiles.size()));
+      }
+    }
+      break;
+    default:
+      throw std::runtime_error{"Unknown rendering mode"};
+  }
+  scheduler_.Run(pool_, tiles, [this](const Tile& tile) { RenderTile(tile); });
+}
+
+bool Renderer::UpdateSampleStatistics() {
+  const Tile region = Region();
+  uint64_t total_samples = 0;
+  double total_squared_error = 0.0;
+  bool errors_estimated = true;
+  for (int32_t row = region.rows[0]; row < region.rows[1]; ++row) {
+    for (int32_t column = region.columns[0]; column < region.columns[1]; ++column) {
+      const int32_t pixel = row * width_ + column;
+      total_samples += sample_counts_[pixel];
+      total_squared_error += static_cast<double>(accumulation_[pixel].error) * accumulation_[pixel].error;
+      errors_estimated &= accumulation_[pixel].converged || sample_counts_[pixel] >= 2;
     }
-    color = ColorCorrection(settings_.samples_per_pixel, color);
-    image_data_[row * preview_->Width() + column] = utils::ColorToRGBA(color);
   }
+  const auto pixels = static_cast<double>(std::max(region.Area(), 1));
+  statistics_.average_samples_per_pixel = static_cast<float>(static_cast<double>(total_samples) / pixels);
+  statistics_.estimated_error = static_cast<float>(std::sqrt(total_squared_error / pixels));
+  return errors_estimated;
 }
 
-void Renderer::RenderChuck(glm::i32vec2 rows, glm::i32vec2 columns) {
-  for (int32_t row = rows[0]; row < rows[1]; ++row) {
-    for (int32_t column = columns[0]; column < columns[1]; ++column) {
-      glm::vec4 color{};
-      for (int32_t sample = 1; sample <= settings_.samples_per_pixel; ++sample) {
-        glm::vec2 coordinate{
-            (static_cast<float>(column) + random::Float()) / static_cast<float>(preview_->Width()),
-            (static_cast<float>(row) + random::Float()) / static_cast<float>(preview_->Height())
-        };
-        const Ray ray = scene_->GetCamera()->ShootRay(coordinate);
-        color += RenderPixel(ray, settings_.max_child_rays);
+void Renderer::RenderTile(const Tile& tile) {
+  using namespace std::chrono;
+  const auto start_time = high_resolution_clock::now();
+  Sampler sampler{static_cast<SamplerType>(settings_.sampler_type), settings_.samples_per_pixel};
+  std::vector<uint32_t> colors(tile.Area(), 0), sample_count_colors(tile.Area(), 0);
+  size_t index = 0;
+  bool all_sampled = true;
+  for (int32_t row = tile.rows[0]; row < tile.rows[1]; ++row) {
+    for (int32_t column = tile.columns[0]; column < tile.columns[1]; ++column, ++index) {
+      SamplePixel(row, column, sampler);
+      const int32_t pixel = row * width_ + column;
+      const auto samples = static_cast<int32_t>(sample_counts_[pixel]);
+      all_sampled &= samples > 0;
+      if (samples == 0) continue;
+      colors[index] = utils::ColorToRGBA(ColorCorrection(samples, {accumulation_[pixel].color, 1.0f}));
+      const float relative_count = static_cast<float>(samples) / static_cast<float>(settings_.samples_per_pixel);
+      sample_count_colors[index] = utils::ColorToRGBA({relative_count, relative_count, relative_count, 1.0f});
+    }
+  }
+
+  auto publish = [&](const Tile& part, size_t first_index) {
+    framebuffer_.Publish(part, colors.data() + first_index);
+    sample_count_map_.Publish(part, sample_count_colors.data() + first_index);
+    ForEachSink([&](const FramebufferSink& sink) {
+      if (sink.on_tile) sink.on_tile(part, colors.data() + first_index);
+    });
+  };
+  if (all_sampled) {
+    publish(tile, 0);
+  } else {
+    // A stop came before some pixels took their first sample, they keep what the previous render left. Only the runs
+    // of sampled pixels of each row are published.
+    for (int32_t row = tile.rows[0]; row < tile.rows[1]; ++row) {
+      const uint32_t* counts = sample_counts_.data() + row * width_;
+      const auto row_index = static_cast<size_t>((row - tile.rows[0]) * tile.Width());
+      int32_t column = tile.columns[0];
+      while (column < tile.columns[1]) {
+        while (column < tile.columns[1] && counts[column] == 0) ++column;
+        const int32_t first_column = column;
+        while (column < tile.columns[1] && counts[column] > 0) ++column;
+        if (column == first_column) continue;
+        publish({{row, row + 1}, {first_column, column}}, row_index + (first_column - tile.columns[0]));
       }
-      color = ColorCorrection(settings_.samples_per_pixel, color);
-      image_data_[row * preview_->Width() + column] = utils::ColorToRGBA(color);
     }
   }
+  tile_costs_.Record(tile, duration<float>(high_resolution_clock::now() - start_time).count());
+}
+
+void Renderer::SamplePixel(int32_t row, int32_t column, Sampler& sampler) {
+  const int32_t pixel = row * width_ + column;
+  PixelAccumulator& accumulator = accumulation_[pixel];
+  if (accumulator.converged) return;
+
+  const auto previous_samples = static_cast<int32_t>(sample_counts_[pixel]);
+  auto samples = previous_samples;
+  const int32_t pass_end = std::min(samples + std::max(settings_.samples_per_pass, 1), settings_.samples_per_pixel);
+  while (samples < pass_end && !stop_token_.stop_requested()) {
+    // Keyed by pixel and sample, an image does not depend on which thread rendered which pixel.
+    sampler.StartPixelSample({column, row}, samples);
+    const glm::vec2 offset = sampler.Get2D();
+    glm::vec2 coordinate{
+        (static_cast<float>(column) + offset.x) / static_cast<float>(width_),
+        (static_cast<float>(row) + offset.y) / static_cast<float>(height_)
+    };
+    const Ray ray = scene_->GetCamera()->ShootRay(coordinate, sampler);
+    const glm::vec3 color = RenderPixel(ray, settings_.max_child_rays, sampler);
+    accumulator.color += color;
+    ++samples;
+
+    const float luminance = utils::Luminance(color);
+    const float delta = luminance - accumulator.luminance_mean;
+    accumulator.luminance_mean += delta / static_cast<float>(samples);
+    accumulator.luminance_squared_deviations += delta * (luminance - accumulator.luminance_mean);
+  }
+
+  if (samples == previous_samples) return;
+  if (samples >= 2) {
+    // Standard error of the mean, carried through the square root of ColorCorrection().
+    const float variance = std::max(accumulator.luminance_squared_deviations, 0.0f) / static_cast<float>(samples - 1);
+    accumulator.error = glm::sqrt(variance / static_cast<float>(samples))
+        / (2.0f * glm::sqrt(accumulator.luminance_mean + 1e-4f));
+  }
+  accumulator.converged = samples >= settings_.samples_per_pixel;
+  if (settings_.adaptive_sampling && samples >= std::max(settings_.adaptive_min_samples, 2)) {
+    accumulator.converged |= accumulator.error < settings_.adaptive_error_threshold;
+  }
+  sample_counts_[pixel] = samples;
 }
 
-glm::vec4 Renderer::RenderPixel(const Ray& ray, int32_t child_rays) {
+glm::vec4 Renderer::RenderPixel(const Ray& ray, int32_t child_rays, Sampler& sampler) {
   glm::vec3 color{0, 0, 0};
 
+  const LightList& lights = scene_->Lights();
+  const auto light_sampling_strategy = static_cast<LightSamplingStrategy>(settings_.light_sampling_strategy);
+  const bool next_event_estimation = settings_.next_event_estimation && !lights.Empty();
+  const auto heuristic = static_cast<MISHeuristic>(settings_.mis_heuristic);
+  // Weights of sampling the lights and the materials.
+  const std::array<float, 2> weights{settings_.light_sampling_weight, 1.0f - settings_.light_sampling_weight};
   Ray current_ray = ray;
   glm::vec3 current_attenuation{1, 1, 1};
+  // Origin of the current ray, if the lights were sampled explicitly there, and the density of its direction.
+  bool lights_sampled = false;
+  glm::vec3 previous_normal{0, 0, 0};
+  float previous_pdf = 0.0f;
+  int32_t depth = 0;
   while (child_rays--) {
     Collision collision{};
     const bool collided = scene_->Collide(current_ray, 0.001f, std::numeric_limits<float>::max(), collision);
@@ -137,22 +402,62 @@ glm::vec4 Renderer::RenderPixel(const Ray& ray, int32_t child_rays) {
         std::visit([&](const auto& material) {
           return material.Emit(current_ray, collision, collision.u, collision.v, collision.point);
         }, *collision.material);
-    color += emitted * current_attenuation;
+    if (lights_sampled && !utils::IsNearZero(emitted)) {
+      // The light was reachable through SampleLights() as well, both estimates are combined.
+      const float light_pdf = lights.PDFValue(current_ray.Origin(),
+                                              previous_normal,
+                                              current_ray.Direction(),
+                                              light_sampling_strategy);
+      const float weight = MISWeight(heuristic, std::array{weights[0] * light_pdf, weights[1] * previous_pdf}, 1);
+      color += emitted * current_attenuation * weight;
+    } else {
+      color += emitted * current_attenuation;
+    }
 
     Ray scattered_ray{};
     glm::vec3 attenuation{0, 0, 0};
     float pdf = 0.0f;
     const bool scattered = std::visit([&](const auto& material) {
-      return material.Scatter(current_ray, collision, attenuation, scattered_ray, pdf);
+      return material.Scatter(current_ray, collision, attenuation, scattered_ray, pdf, sampler);
     }, *collision.material);
     if (!scattered) {
       break;
     }
-    if (scene_->Light()) {
-      MixturePDF<CollidablePDF, CosinePDF> mixture_pdf{CollidablePDF{*scene_->Light(), collision.point},
-                                                       CosinePDF{collision.normal}};
-      scattered_ray = Ray{collision.point, mixture_pdf.Generate(), ray.Time()};
-      pdf = mixture_pdf.Value(scattered_ray.Direction());
+    // Terminates dim paths at random, the surviving ones carry their contribution. Decided before a direction is
+    // sampled, since the density of a direction towards a light lowers the attenuation it is about to gather.
+    if (settings_.russian_roulette && ++depth >= settings_.russian_roulette_depth) {
+      const glm::vec3 throughput = current_attenuation * attenuation;
+      const float survival = std::min(1.0f, std::max({throughput.r, throughput.g, throughput.b}));
+      if (sampler.Get1D() >= survival) break;
+      current_attenuation /= survival;
+    }
+    const bool specular = std::visit([](const auto& material) { return material.IsSpecular(); }, *collision.material);
+    if (specular) {
+      // Neither the lights nor a density can improve on the single direction the material chose.
+      lights_sampled = false;
+      current_ray = scattered_ray;
+      current_attenuation *= attenuation;
+      continue;
+    }
+    if (next_event_estimation) {
+      color += current_attenuation * attenuation
+          * SampleLights(current_ray, collision, light_sampling_strategy, weights, heuristic, sampler);
+      if (pdf <= 0.0f) break;
+      lights_sampled = true;
+      previous_normal = collision.normal;
+      previous_pdf = pdf;
+    } else if (!lights.Empty()) {
+      const MultipleImportancePDF<LightPDF, MaterialPDF> mis_pdf{
+          weights, heuristic,
+          LightPDF{lights, light_sampling_strategy, collision.point, collision.normal},
+          MaterialPDF{current_ray, collision}};
+      size_t technique;
+      const glm::vec3 direction = mis_pdf.Generate(technique, sampler);
+      // No light contributes to this point, such a sample carries no contribution.
+      if (utils::IsNearZero(direction)) break;
+      scattered_ray = Ray{collision.point, direction, ray.Time()};
+      pdf = mis_pdf.Value(scattered_ray.Direction(), technique);
+      if (pdf <= 0.0f) break;
     }
     current_ray = scattered_ray;
     current_attenuation *= attenuation * std::visit([&](const auto& material) {
@@ -164,6 +469,36 @@ glm::vec4 Renderer::RenderPixel(const Ray& ray, int32_t child_rays) {
   return {color, 1.0f};
 }
 
+glm::vec3 Renderer::SampleLights(const Ray& ray,
+                                 const Collision& collision,
+                                 LightSamplingStrategy strategy,
+                                 const std::array<float, 2>& weights,
+                                 MISHeuristic heuristic,
+                                 Sampler& sampler) const {
+  const LightList& lights = scene_->Lights();
+  const glm::vec3 direction = lights.RandomTowards(collision.point, collision.normal, strategy, sampler);
+  if (utils::IsNearZero(direction)) return {0, 0, 0};
+
+  const Ray shadow_ray{collision.point, direction, ray.Time()};
+  const float scattering_pdf = std::visit([&](const auto& material) {
+    return material.ScatteringPDF(ray, collision, shadow_ray);
+  }, *collision.material);
+  if (scattering_pdf <= 0.0f) return {0, 0, 0};
+
+  Collision light_collision{};
+  if (!scene_->Collide(shadow_ray, 0.001f, std::numeric_limits<float>::max(), light_collision)) return {0, 0, 0};
+  const glm::vec3 emitted = std::visit([&](const auto& material) {
+    return material.Emit(shadow_ray, light_collision, light_collision.u, light_collision.v, light_collision.point);
+  }, *light_collision.material);
+  if (utils::IsNearZero(emitted)) return {0, 0, 0};
+
+  const float light_pdf = lights.PDFValue(collision.point, collision.normal, direction, strategy);
+  // Directions grazing the light have no finite density.
+  if (!std::isfinite(light_pdf) || light_pdf <= 0.0f) return {0, 0, 0};
+  const float weight = MISWeight(heuristic, std::array{weights[0] * light_pdf, weights[1] * scattering_pdf}, 0);
+  return emitted * scattering_pdf / light_pdf * weight;
+}
+
 glm::vec4 Renderer::ColorCorrection(int32_t samples_per_pixel, const glm::vec4& color) {
   glm::vec3 corrected = color;
   corrected *= 1.0f / static_cast<float>(samples_per_pixel);
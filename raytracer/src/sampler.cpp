@@ -0,0 +1,217 @@
+#include "sampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace rt {
+namespace {
+constexpr float kOneMinusEpsilon = 0x1.fffffep-1f;
+
+constexpr std::array<uint32_t, 48> kPrimes{
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89,
+    97, 101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223};
+
+float ToFloat(uint32_t bits) {
+  return static_cast<float>(bits >> 8u) * 0x1p-24f;
+}
+
+/**
+ * @return Element i of a random permutation of [0, length) selected by the seed, from Kensler's "Correlated
+ * Multi-Jittered Sampling".
+ */
+uint32_t PermutationElement(uint32_t i, uint32_t length, uint32_t seed) {
+  uint32_t w = length - 1;
+  w |= w >> 1u;
+  w |= w >> 2u;
+  w |= w >> 4u;
+  w |= w >> 8u;
+  w |= w >> 16u;
+  do {
+    i ^= seed;
+    i *= 0xe170893du;
+    i ^= seed >> 16u;
+    i ^= (i & w) >> 4u;
+    i ^= seed >> 8u;
+    i *= 0x0929eb3fu;
+    i ^= seed >> 23u;
+    i ^= (i & w) >> 1u;
+    i *= 1u | seed >> 27u;
+    i *= 0x6935fa69u;
+    i ^= (i & w) >> 11u;
+    i *= 0x74dcb303u;
+    i ^= (i & w) >> 2u;
+    i *= 0x9e501cc3u;
+    i ^= (i & w) >> 2u;
+    i *= 0xc860a3dfu;
+    i &= w;
+    i ^= i >> 5u;
+  } while (i >= length);
+  return (i + seed) % length;
+}
+
+uint32_t MixBits(uint64_t value) {
+  value ^= value >> 31u;
+  value *= 0x7fb5d329728ea185ULL;
+  value ^= value >> 27u;
+  value *= 0x81dadef4bc2dd44dULL;
+  value ^= value >> 33u;
+  return static_cast<uint32_t>(value);
+}
+
+uint32_t ReverseBits(uint32_t value) {
+  value = ((value >> 1u) & 0x55555555u) | ((value & 0x55555555u) << 1u);
+  value = ((value >> 2u) & 0x33333333u) | ((value & 0x33333333u) << 2u);
+  value = ((value >> 4u) & 0x0f0f0f0fu) | ((value & 0x0f0f0f0fu) << 4u);
+  value = ((value >> 8u) & 0x00ff00ffu) | ((value & 0x00ff00ffu) << 8u);
+  return (value >> 16u) | (value << 16u);
+}
+
+/**
+ * Owen scrambling in base 2 through Laine and Karras' hash, as in Burley's "Practical Hash-based Owen Scrambling".
+ */
+uint32_t OwenScramble(uint32_t value, uint32_t seed) {
+  value = ReverseBits(value);
+  value += seed;
+  value ^= value * 0x6c50b47cu;
+  value ^= value * 0xb82f1e52u;
+  value ^= value * 0xc7afe638u;
+  value ^= value * 0x8d22f6e6u;
+  return ReverseBits(value);
+}
+
+/**
+ * @return Point of the first two dimensions of the Sobol sequence, which form a (0, 2)-sequence.
+ */
+uint32_t SobolSample(uint32_t index, uint32_t dimension) {
+  uint32_t result = 0;
+  for (uint32_t v = 1u << 31u; index; index >>= 1u) {
+    if (index & 1u) result ^= v;
+    v = dimension == 0 ? v >> 1u : v ^ (v >> 1u);
+  }
+  return result;
+}
+
+/**
+ * @return Radical inverse of the index in the base, each digit permuted depending on the less significant ones.
+ */
+float OwenScrambledRadicalInverse(uint32_t base, uint32_t index, uint32_t seed) {
+  if (base == 2) return ToFloat(OwenScramble(ReverseBits(index), seed));
+  const float inverse_base = 1.0f / static_cast<float>(base);
+  uint64_t reversed = 0;
+  float inverse_base_power = 1.0f;
+  while (index > 0) {
+    const uint32_t next = index / base;
+    uint32_t digit = index - next * base;
+    const auto digit_seed = MixBits(seed ^ reversed);
+    digit = PermutationElement(digit, base, digit_seed);
+    reversed = reversed * base + digit;
+    inverse_base_power *= inverse_base;
+    index = next;
+  }
+  // The remaining digits are zero, permuting each of them independently yields a uniformly distributed tail.
+  const float tail = ToFloat(MixBits((static_cast<uint64_t>(seed) << 32u) ^ reversed));
+  return std::min((static_cast<float>(reversed) + tail) * inverse_base_power, kOneMinusEpsilon);
+}
+}  // namespace
+
+Sampler::Sampler(SamplerType type, int32_t samples_per_pixel)
+    : type_{type}, samples_per_pixel_{static_cast<uint32_t>(std::max(samples_per_pixel, 1))} {}
+
+void Sampler::StartPixelSample(const glm::i32vec2& pixel, int32_t sample) {
+  pixel_hash_ = random::Hash(static_cast<uint32_t>(pixel.x), static_cast<uint32_t>(pixel.y));
+  sample_ = static_cast<uint32_t>(sample);
+  dimension_ = 0;
+  generator_ = random::Generator{random::Hash(pixel_hash_, sample_)};
+}
+
+float Sampler::Get1D() {
+  const auto seed = static_cast<uint32_t>(DimensionHash());
+  float value;
+  switch (type_) {
+    case SamplerType::Independent: {
+      value = random::Float(generator_);
+    }
+      break;
+    case SamplerType::Stratified: {
+      // Samples beyond the strata start another round with a different permutation.
+      const uint32_t round = sample_ / samples_per_pixel_;
+      const uint32_t stratum = PermutationElement(sample_ % samples_per_pixel_,
+                                                  samples_per_pixel_,
+                                                  static_cast<uint32_t>(random::Hash(seed, round)));
+      value = (static_cast<float>(stratum) + random::Float(generator_)) / static_cast<float>(samples_per_pixel_);
+    }
+      break;
+    case SamplerType::Halton: {
+      value = dimension_ < kPrimes.size() ?
+              OwenScrambledRadicalInverse(kPrimes[dimension_], sample_, seed) :
+              random::Float(generator_);
+    }
+      break;
+    case SamplerType::Sobol: {
+      value = ToFloat(OwenScramble(SobolSample(OwenScramble(sample_, seed), 0), seed ^ 0x9e3779b9u));
+    }
+      break;
+    default: {
+      assert(false);
+      value = 0.0f;
+    }
+  }
+  ++dimension_;
+  return std::min(value, kOneMinusEpsilon);
+}
+
+glm::vec2 Sampler::Get2D() {
+  const auto seed = static_cast<uint32_t>(DimensionHash());
+  glm::vec2 value;
+  switch (type_) {
+    case SamplerType::Independent: {
+      value.x = random::Float(generator_);
+      value.y = random::Float(generator_);
+    }
+      break;
+    case SamplerType::Stratified: {
+      // The strata form a grid which may hold a few more cells than samples, each sample still gets its own.
+      const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(samples_per_pixel_))));
+      const uint32_t rows = (samples_per_pixel_ + columns - 1) / columns;
+      const uint32_t cells = columns * rows;
+      const uint32_t round = sample_ / samples_per_pixel_;
+      const uint32_t cell = PermutationElement(sample_ % samples_per_pixel_,
+                                               cells,
+                                               static_cast<uint32_t>(random::Hash(seed, round)));
+      value.x = (static_cast<float>(cell % columns) + random::Float(generator_)) / static_cast<float>(columns);
+      value.y = (static_cast<float>(cell / columns) + random::Float(generator_)) / static_cast<float>(rows);
+    }
+      break;
+    case SamplerType::Halton: {
+      if (dimension_ + 1 < kPrimes.size()) {
+        value.x = OwenScrambledRadicalInverse(kPrimes[dimension_], sample_, seed);
+        value.y = OwenScrambledRadicalInverse(kPrimes[dimension_ + 1], sample_, seed ^ 0x9e3779b9u);
+      } else {
+        value.x = random::Float(generator_);
+        value.y = random::Float(generator_);
+      }
+    }
+      break;
+    case SamplerType::Sobol: {
+      // Shuffling the index by Owen scrambling keeps every power of two prefix a (0, 2)-sequence.
+      const uint32_t index = OwenScramble(sample_, seed);
+      value.x = ToFloat(OwenScramble(SobolSample(index, 0), seed ^ 0x9e3779b9u));
+      value.y = ToFloat(OwenScramble(SobolSample(index, 1), seed ^ 0x7f4a7c15u));
+    }
+      break;
+    default: {
+      assert(false);
+      value = {0.0f, 0.0f};
+    }
+  }
+  dimension_ += 2;
+  return glm::min(value, glm::vec2{kOneMinusEpsilon});
+}
+
+uint64_t Sampler::DimensionHash() const {
+  return random::Hash(pixel_hash_, dimension_);
+}
+
+}  // namespace rt
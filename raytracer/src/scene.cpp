@@ -1,5 +1,6 @@
 #include "scene.h"
 
+#include <numbers>
 #include <stdexcept>
 #include <variant>
 
@@ -9,7 +10,7 @@
 
 namespace rt {
 Scene::Scene(SceneType scene_type, float aspect_ratio, BVHSplitStrategy bvh_split_strategy)
-    : aspect_ratio_{aspect_ratio}, bvh_split_strategy_{bvh_split_strategy} {
+    : scene_type_{scene_type}, aspect_ratio_{aspect_ratio}, bvh_split_strategy_{bvh_split_strategy} {
   switch (scene_type) {
     case SceneType::Part3Section10:
       InitializePart3Section10();
@@ -17,6 +18,9 @@ Scene::Scene(SceneType scene_type, float aspect_ratio, BVHSplitStrategy bvh_spli
     default:
       throw std::runtime_error{"Unknown scene."};
   }
+  Animate();
+  BuildBVH();
+  lights_ = LightList{collidables_};
 }
 
 bool Scene::Collide(const Ray& ray, float t_min, float t_max, Collision& collision) const {
@@ -25,12 +29,14 @@ bool Scene::Collide(const Ray& ray, float t_min, float t_max, Collision& collisi
   } else {
     bool collided = false;
     float closest = t_max;
-    for (const auto& collidable : collidables_) {
-      if (std::visit([&](const auto& object) { return object.Collide(ray, t_min, closest, collision); }, collidable)) {
-        collided = true;
-        closest = collision.t;
+    collidables_.ForEachPool([&](const auto& pool) {
+      for (const auto& collidable : pool) {
+        if (collidable.Collide(ray, t_min, closest, collision)) {
+          collided = true;
+          closest = collision.t;
+        }
       }
-    }
+    });
     return collided;
   }
 }
@@ -43,20 +49,108 @@ glm::vec3 Scene::BackgroundColor() const {
   return background_color_;
 }
 
-collidable_t* Scene::Light() const {
-  return light_.get();
+const LightList& Scene::Lights() const {
+  return lights_;
+}
+
+const TextureRegistry& Scene::Textures() const {
+  return textures_;
+}
+
+SceneType Scene::Type() const {
+  return scene_type_;
+}
+
+float Scene::AspectRatio() const {
+  return aspect_ratio_;
+}
+
+BVHSplitStrategy Scene::SplitStrategy() const {
+  return bvh_split_strategy_;
+}
+
+float Scene::Time() const {
+  return time_;
+}
+
+void Scene::SetAspectRatio(float aspect_ratio) {
+  if (aspect_ratio == aspect_ratio_) return;
+  aspect_ratio_ = aspect_ratio;
+  camera_->SetAspectRatio(aspect_ratio);
+}
+
+void Scene::SetSplitStrategy(BVHSplitStrategy bvh_split_strategy) {
+  if (bvh_split_strategy == bvh_split_strategy_) return;
+  bvh_split_strategy_ = bvh_split_strategy;
+  BuildBVH();
+}
+
+void Scene::SetTime(float time) {
+  if (time == time_) return;
+  time_ = time;
+  Animate();
+  bvh_->Refit();
+  // Emitters may move as well, the lights are sampled by their bounds and the tree over them.
+  lights_ = LightList{collidables_};
+}
+
+void Scene::BuildBVH() {
+  bvh_ = std::make_unique<BVH>(bvh_split_strategy_, collidables_, 0.0f, 1.0f);
+}
+
+void Scene::Animate() {
+  switch (scene_type_) {
+    case SceneType::Part3Section10:
+      AnimatePart3Section10();
+      break;
+    default:
+      throw std::runtime_error{"Unknown scene."};
+  }
 }
 
 void Scene::InitializePart3Section10() {
   background_color_ = {0.0f, 0.0f, 0.0f};
 
-  constexpr glm::vec3 camera_origin{278, 278, -800};
+  collidables_.Add(RectangleYZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 555.0f,
+                               Lambertian{SolidColorTexture{0.12f, 0.45f, 0.15f}}});
+  collidables_.Add(RectangleYZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 0.0f,
+                               Lambertian{SolidColorTexture{0.65f, 0.05f, 0.05f}}});
+  collidables_.Add(RectangleXZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 0.0f,
+                               Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}});
+  collidables_.Add(RectangleXZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 555.0f,
+                               Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}});
+  collidables_.Add(RectangleXY{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 555.0f,
+                               Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}});
+
+  collidables_.Add(Flip{RectangleXZ{glm::vec2{213.0f, 343.0f}, glm::vec2{227.0f, 332.0f}, 554.0f,
+                                    DiffuseLight{glm::vec3{15.0f, 15.0f, 15.0f}}}});
+
+  animated_transforms_.push_back(collidables_.Add(Transform{Box{glm::vec3{0.0f, 0.0f, 0.0f},
+                                                                glm::vec3{165.0f, 330.0f, 165.0f},
+                                                                Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}}})
+                                     .index);
+
+  collidables_.Add(Transform{Box{glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{165.0f, 165.0f, 165.0f},
+                                 Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}},
+                             -18.0f, glm::vec3{130.0f, 0.0f, 65.0f}});
+}
+
+void Scene::AnimatePart3Section10() {
+  // The camera sways around the center of the box while the tall box turns.
   constexpr glm::vec3 camera_target{278, 278, 0};
+  constexpr float camera_distance = 800.0f;
+  constexpr float camera_sway_degrees = 10.0f;
+  constexpr float camera_sway_period = 4.0f;
   constexpr glm::vec3 camera_vup{0, 1, 0};
   constexpr float camera_fov = 40.0f;
   constexpr float camera_aperture = 0.0f;
   constexpr float camera_focus_distance = 10.0f;
+  constexpr float tall_box_degrees_per_second = 45.0f;
 
+  const float camera_angle = glm::radians(camera_sway_degrees)
+      * glm::sin(2.0f * std::numbers::pi_v<float> * time_ / camera_sway_period);
+  const glm::vec3 camera_origin
+      = camera_target + camera_distance * glm::vec3{glm::sin(camera_angle), 0.0f, -glm::cos(camera_angle)};
   camera_ = std::make_unique<Camera>(camera_origin,
                                      camera_target,
                                      camera_vup,
@@ -67,31 +161,8 @@ void Scene::InitializePart3Section10() {
                                      0.0f,
                                      1.0f);
 
-  collidables_.emplace_back(RectangleYZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 555.0f,
-                                        Lambertian{SolidColorTexture{0.12f, 0.45f, 0.15f}}});
-  collidables_.emplace_back(RectangleYZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 0.0f,
-                                        Lambertian{SolidColorTexture{0.65f, 0.05f, 0.05f}}});
-  collidables_.emplace_back(RectangleXZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 0.0f,
-                                        Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}});
-  collidables_.emplace_back(RectangleXZ{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 555.0f,
-                                        Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}});
-  collidables_.emplace_back(RectangleXY{glm::vec2{0.0f, 555.0f}, glm::vec2{0.0f, 555.0f}, 555.0f,
-                                        Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}});
-
-  collidables_.emplace_back(Flip{RectangleXZ{glm::vec2{213.0f, 343.0f}, glm::vec2{227.0f, 332.0f}, 554.0f,
-                                             DiffuseLight{glm::vec3{15.0f, 15.0f, 15.0f}}}});
-
-  collidables_.emplace_back(Transform{Box{glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{165.0f, 330.0f, 165.0f},
-                                          Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}},
-                                      15.0f, glm::vec3{265.0f, 0.0f, 295.0f}});
-
-  collidables_.emplace_back(Transform{Box{glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{165.0f, 165.0f, 165.0f},
-                                          Lambertian{SolidColorTexture{0.73f, 0.73f, 0.73f}}},
-                                      -18.0f, glm::vec3{130.0f, 0.0f, 65.0f}});
-
-  bvh_ = std::make_unique<BVH>(bvh_split_strategy_, collidables_, 0.0f, 1.0f);
-  light_ = std::make_unique<collidable_t>(RectangleXZ{glm::vec2{213.0f, 343.0f}, glm::vec2{227.0f, 332.0f}, 554.0f,
-                                                      DiffuseLight{glm::vec3{15.0f, 15.0f, 15.0f}}});
+  Transform& tall_box = collidables_.Pool<Transform>()[animated_transforms_[0]];
+  tall_box.SetTransformation(15.0f + tall_box_degrees_per_second * time_, glm::vec3{265.0f, 0.0f, 295.0f});
 }
 
 }  // namespace rt
@@ -0,0 +1,170 @@
+#include "socket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace rt {
+namespace {
+constexpr std::string_view kUnixPrefix = "unix:";
+constexpr int kListenBacklog = 64;
+
+struct Address {
+  sockaddr_storage storage{};
+  socklen_t length = 0;
+  int family = AF_UNSPEC;
+};
+
+Address ResolveAddress(const std::string& address, bool passive) {
+  Address resolved;
+  if (address.starts_with(kUnixPrefix)) {
+    const std::string path = address.substr(kUnixPrefix.size());
+    sockaddr_un unix_address{};
+    if (path.empty() || path.size() >= sizeof(unix_address.sun_path)) {
+      throw std::runtime_error{std::format("Invalid socket path: {}.", path)};
+    }
+    unix_address.sun_family = AF_UNIX;
+    std::memcpy(unix_address.sun_path, path.c_str(), path.size() + 1);
+    std::memcpy(&resolved.storage, &unix_address, sizeof(unix_address));
+    resolved.length = sizeof(unix_address);
+    resolved.family = AF_UNIX;
+    return resolved;
+  }
+
+  const size_t separator = address.rfind(':');
+  if (separator == std::string::npos) {
+    throw std::runtime_error{std::format("Address is neither unix:<path> nor <host>:<port>: {}.", address)};
+  }
+  const std::string host = address.substr(0, separator), port = address.substr(separator + 1);
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+  addrinfo* results = nullptr;
+  if (const int error = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &results)) {
+    throw std::runtime_error{std::format("Failed to resolve {}: {}.", address, gai_strerror(error))};
+  }
+  std::memcpy(&resolved.storage, results->ai_addr, results->ai_addrlen);
+  resolved.length = results->ai_addrlen;
+  resolved.family = results->ai_family;
+  freeaddrinfo(results);
+  return resolved;
+}
+
+Socket OpenSocket(const Address& address, int flags = 0) {
+  Socket socket{::socket(address.family, SOCK_STREAM | SOCK_CLOEXEC | flags, 0)};
+  if (!socket.Valid()) throw std::runtime_error{std::format("Failed to open a socket: {}.", std::strerror(errno))};
+  return socket;
+}
+
+void DisableNagle(const Socket& socket, int family) {
+  // Tiles are sent as they finish, batching them up would only delay the next tile.
+  if (family == AF_UNIX) return;
+  const int enable = 1;
+  setsockopt(socket.Fd(), IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+}  // namespace
+
+Socket::Socket(int fd) : fd_{fd} {}
+
+Socket::Socket(Socket&& other) noexcept : fd_{std::exchange(other.fd_, -1)} {}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+  if (this != &other) {
+    Close();
+    fd_ = std::exchange(other.fd_, -1);
+  }
+  return *this;
+}
+
+Socket::~Socket() {
+  Close();
+}
+
+Socket Socket::Listen(const std::string& address) {
+  const Address resolved = ResolveAddress(address, true);
+  // Accepting must not block when a peer which was pending has gone away since.
+  Socket socket = OpenSocket(resolved, SOCK_NONBLOCK);
+  if (resolved.family == AF_UNIX) {
+    // A coordinator which did not shut down cleanly leaves its socket file behind.
+    unlink(reinterpret_cast<const sockaddr_un*>(&resolved.storage)->sun_path);
+  } else {
+    const int enable = 1;
+    setsockopt(socket.Fd(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  }
+  if (bind(socket.Fd(), reinterpret_cast<const sockaddr*>(&resolved.storage), resolved.length) != 0
+      || listen(socket.Fd(), kListenBacklog) != 0) {
+    throw std::runtime_error{std::format("Failed to listen at {}: {}.", address, std::strerror(errno))};
+  }
+  return socket;
+}
+
+Socket Socket::Connect(const std::string& address) {
+  const Address resolved = ResolveAddress(address, false);
+  Socket socket = OpenSocket(resolved);
+  if (connect(socket.Fd(), reinterpret_cast<const sockaddr*>(&resolved.storage), resolved.length) != 0) {
+    throw std::runtime_error{std::format("Failed to connect to {}: {}.", address, std::strerror(errno))};
+  }
+  DisableNagle(socket, resolved.family);
+  return socket;
+}
+
+Socket Socket::Accept() const {
+  sockaddr_storage peer{};
+  socklen_t length = sizeof(peer);
+  Socket socket{accept4(fd_, reinterpret_cast<sockaddr*>(&peer), &length, SOCK_CLOEXEC)};
+  if (socket.Valid()) DisableNagle(socket, peer.ss_family);
+  return socket;
+}
+
+bool Socket::Send(const void* data, size_t size) const {
+  const auto* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    // Without MSG_NOSIGNAL a peer gone away would raise SIGPIPE and end the process.
+    const ssize_t sent = send(fd_, bytes, size, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) continue;
+    if (sent <= 0) return false;
+    bytes += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+bool Socket::Receive(void* data, size_t size) const {
+  auto* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t received = recv(fd_, bytes, size, 0);
+    if (received < 0 && errno == EINTR) continue;
+    if (received <= 0) return false;
+    bytes += received;
+    size -= static_cast<size_t>(received);
+  }
+  return true;
+}
+
+ptrdiff_t Socket::ReceiveAvailable(void* data, size_t size) const {
+  while (true) {
+    const ssize_t received = recv(fd_, data, size, MSG_DONTWAIT);
+    if (received > 0) return received;
+    if (received < 0 && errno == EINTR) continue;
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+    return -1;
+  }
+}
+
+void Socket::Close() {
+  if (fd_ < 0) return;
+  close(fd_);
+  fd_ = -1;
+}
+}  // namespace rt
@@ -3,9 +3,40 @@
 #include <cmath>
 #include <numbers>
 
+#include "onb.h"
+#include "random.h"
 #include "utils.h"
 
 namespace rt {
+namespace {
+float ConePDFValue(const glm::vec3& center, float radius, const glm::vec3& origin, const glm::vec3& direction) {
+  const glm::vec3 to_center = center - origin;
+  const float distance_squared = glm::dot(to_center, to_center);
+  if (distance_squared <= radius * radius) {
+    // Inside the sphere, every direction reaches its surface.
+    return 1.0f / (4.0f * std::numbers::pi_v<float>);
+  }
+  const float cos_theta_max = glm::sqrt(1.0f - radius * radius / distance_squared);
+  const float cos_theta = glm::dot(to_center, direction) / glm::sqrt(distance_squared * glm::dot(direction, direction));
+  if (cos_theta < cos_theta_max) return 0.0f;
+  const float solid_angle = 2.0f * std::numbers::pi_v<float> * (1.0f - cos_theta_max);
+  return 1.0f / solid_angle;
+}
+
+glm::vec3 ConeRandomTowards(const glm::vec3& center,
+                            float radius,
+                            const glm::vec3& origin,
+                            Sampler& sampler) {
+  const glm::vec3 to_center = center - origin;
+  const float distance_squared = glm::dot(to_center, to_center);
+  if (distance_squared <= radius * radius) {
+    return random::UnitVec3(sampler.Get2D());
+  }
+  const ONB onb{to_center};
+  return onb.Local(random::ToSphere(sampler.Get2D(), radius, distance_squared));
+}
+}  // namespace
+
 Sphere::Sphere(glm::vec3 center, float radius, material_t material)
     : center_{center}, radius_{radius}, material_{material} {}
 
@@ -52,14 +83,24 @@ glm::vec3 Sphere::Centroid() const {
   return center_;
 }
 
+float Sphere::Area() const {
+  return 4.0f * std::numbers::pi_v<float> * radius_ * radius_;
+}
+
+const material_t* Sphere::GetMaterial() const {
+  return &material_;
+}
+
+DirectionCone Sphere::NormalBounds() const {
+  return DirectionCone::Entire();
+}
+
 float Sphere::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  return ConePDFValue(center_, radius_, origin, direction);
 }
 
-glm::vec3 Sphere::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 Sphere::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  return ConeRandomTowards(center_, radius_, origin, sampler);
 }
 
 void Sphere::ComputeUV(const glm::vec3& point, float& u, float& v) {
@@ -122,14 +163,25 @@ glm::vec3 MovingSphere::Centroid() const {
   return center0_ + (center1_ - center0_) / 2.0f;
 }
 
+float MovingSphere::Area() const {
+  return 4.0f * std::numbers::pi_v<float> * radius_ * radius_;
+}
+
+const material_t* MovingSphere::GetMaterial() const {
+  return &material_;
+}
+
+DirectionCone MovingSphere::NormalBounds() const {
+  return DirectionCone::Entire();
+}
+
 float MovingSphere::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  // Sampling has no notion of time, so the sphere is sampled at the middle of its motion.
+  return ConePDFValue(Centroid(), radius_, origin, direction);
 }
 
-glm::vec3 MovingSphere::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 MovingSphere::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  return ConeRandomTowards(Centroid(), radius_, origin, sampler);
 }
 
 glm::vec3 MovingSphere::CenterAt(float time) const {
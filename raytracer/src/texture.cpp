@@ -1,8 +1,7 @@
 #include "texture.h"
 
 #include <algorithm>
-
-#include "utils.h"
+#include <utility>
 
 namespace rt {
 
@@ -14,25 +13,27 @@ glm::vec3 SolidColorTexture::Sample(float u, float v, const glm::vec3& point) co
   return color_;
 }
 
-NoiseTexture::NoiseTexture(float scale) : scale_{scale} {}
+NoiseTexture::NoiseTexture(std::shared_ptr<const Perlin> perlin, float scale)
+    : perlin_{std::move(perlin)}, scale_{scale} {}
 
 glm::vec3 NoiseTexture::Sample(float u, float v, const glm::vec3& point) const {
-  return glm::vec3{1, 1, 1} * 0.5f * (1.0f + sinf(scale_ * point.z + 10.0f * perlin_.Turbulence(scale_ * point)));
+  return glm::vec3{1, 1, 1} * 0.5f * (1.0f + sinf(scale_ * point.z + 10.0f * perlin_->Turbulence(scale_ * point)));
 }
 
-ImageTexture::ImageTexture(const std::filesystem::path& path) : buffer_{utils::png::Decode(path, width_, height_)} {}
+ImageTexture::ImageTexture(std::shared_ptr<const ImageData> image) : image_{std::move(image)} {}
 
 glm::vec3 ImageTexture::Sample(float u, float v, const glm::vec3& point) const {
+  const ImageData& image = *image_;
   u = std::clamp(u, 0.0f, 1.0f);
   v = 1.0f - std::clamp(v, 0.0f, 1.0f);
-  auto column = static_cast<int32_t>(u * static_cast<float>(width_));
-  column = std::clamp(column, 0, width_ - 1);
-  auto row = static_cast<int32_t>(v * static_cast<float>(height_));
-  row = std::clamp(row, 0, height_ - 1);
-  const uint32_t pixel_index = row * width_ * 3 + column * 3;
-  const uint8_t red = buffer_[pixel_index + 0];
-  const uint8_t green = buffer_[pixel_index + 1];
-  const uint8_t blue = buffer_[pixel_index + 2];
+  auto column = static_cast<int32_t>(u * static_cast<float>(image.width));
+  column = std::clamp(column, 0, image.width - 1);
+  auto row = static_cast<int32_t>(v * static_cast<float>(image.height));
+  row = std::clamp(row, 0, image.height - 1);
+  const uint32_t pixel_index = row * image.width * 3 + column * 3;
+  const uint8_t red = image.buffer[pixel_index + 0];
+  const uint8_t green = image.buffer[pixel_index + 1];
+  const uint8_t blue = image.buffer[pixel_index + 2];
   constexpr float color_scale = 1.0f / 255.0f;
   return glm::vec3{red, green, blue} * color_scale;
 }
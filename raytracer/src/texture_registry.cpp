@@ -0,0 +1,53 @@
+#include "texture_registry.h"
+
+#include <utility>
+
+#include "utils.h"
+
+namespace rt {
+ImageTexture TextureRegistry::GetImage(const std::filesystem::path& path) {
+  auto& image = images_[Key(path)];
+  if (!image) {
+    ImageData data;
+    data.buffer = utils::png::Decode(path, data.width, data.height);
+    image = std::make_shared<const ImageData>(std::move(data));
+  }
+  return ImageTexture{image};
+}
+
+NoiseTexture TextureRegistry::GetNoise(float scale, uint32_t lattice) {
+  auto& perlin = lattices_[lattice];
+  if (!perlin) {
+    perlin = std::make_shared<const Perlin>(lattice);
+  }
+  return NoiseTexture{perlin, scale};
+}
+
+uint32_t TextureRegistry::ReferenceCount(const std::filesystem::path& path) const {
+  const auto it = images_.find(Key(path));
+  if (it == images_.end()) return 0;
+  // The registry itself holds one reference.
+  return static_cast<uint32_t>(it->second.use_count() - 1);
+}
+
+TextureMemoryUsage TextureRegistry::MemoryUsage() const {
+  TextureMemoryUsage usage;
+  for (const auto& [key, image] : images_) {
+    ++usage.image_count;
+    usage.image_bytes += sizeof(ImageData) + image->buffer.capacity() * sizeof(uint8_t);
+  }
+  usage.noise_count = static_cast<uint32_t>(lattices_.size());
+  usage.noise_bytes = lattices_.size() * sizeof(Perlin);
+  return usage;
+}
+
+void TextureRegistry::Purge() {
+  std::erase_if(images_, [](const auto& entry) { return entry.second.use_count() == 1; });
+  std::erase_if(lattices_, [](const auto& entry) { return entry.second.use_count() == 1; });
+}
+
+std::string TextureRegistry::Key(const std::filesystem::path& path) {
+  return std::filesystem::weakly_canonical(path).string();
+}
+
+}  // namespace rt
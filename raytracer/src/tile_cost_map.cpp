@@ -0,0 +1,89 @@
+#include "tile_cost_map.h"
+
+#include <algorithm>
+
+namespace rt {
+void TileCostMap::Reset(const Tile& region) {
+  region_ = region;
+  width_ = std::max(region.Width(), 0);
+  height_ = std::max(region.Height(), 0);
+  costs_.assign(static_cast<size_t>(width_) * height_, 0.0f);
+}
+
+void TileCostMap::Record(const Tile& tile, float seconds) {
+  const float cost = seconds / static_cast<float>(std::max(tile.Area(), 1));
+  for (int32_t row = tile.rows[0] - region_.rows[0]; row < tile.rows[1] - region_.rows[0]; ++row) {
+    std::fill_n(costs_.begin() + row * width_ + tile.columns[0] - region_.columns[0], tile.Width(), cost);
+  }
+}
+
+std::vector<Tile> TileCostMap::BalancedTiles(int32_t tile_count) const {
+  // Summed area table, each entry holds the cost of the pixels above and to the left of it.
+  std::vector<double> summed_costs(static_cast<size_t>(width_ + 1) * (height_ + 1), 0.0);
+  for (int32_t row = 0; row < height_; ++row) {
+    double row_cost = 0.0;
+    for (int32_t column = 0; column < width_; ++column) {
+      row_cost += costs_[row * width_ + column];
+      summed_costs[(row + 1) * (width_ + 1) + column + 1] = summed_costs[row * (width_ + 1) + column + 1] + row_cost;
+    }
+  }
+
+  std::vector<Tile> tiles;
+  tiles.reserve(std::max(tile_count, 1));
+  Split({{0, height_}, {0, width_}}, std::max(tile_count, 1), summed_costs, tiles);
+  for (Tile& tile : tiles) {
+    tile.rows += region_.rows[0];
+    tile.columns += region_.columns[0];
+  }
+  return tiles;
+}
+
+void TileCostMap::Split(const Tile& tile,
+                        int32_t tile_count,
+                        const std::vector<double>& summed_costs,
+                        std::vector<Tile>& tiles) const {
+  const bool split_columns = tile.Width() >= tile.Height();
+  const glm::i32vec2 extent = split_columns ? tile.columns : tile.rows;
+  if (tile_count <= 1 || extent[1] - extent[0] < 2) {
+    tiles.push_back(tile);
+    return;
+  }
+
+  // The first part gets its share of the tiles and, as far as the pixels allow, the same share of the cost.
+  const int32_t first_count = tile_count / 2;
+  const double total_cost = Cost(tile, summed_costs);
+  const double share = static_cast<double>(first_count) / static_cast<double>(tile_count);
+  auto first_part = [&](int32_t position) {
+    Tile first = tile;
+    (split_columns ? first.columns : first.rows)[1] = position;
+    return first;
+  };
+  int32_t position;
+  if (total_cost > 0.0) {
+    int32_t low = extent[0] + 1, high = extent[1] - 1;
+    while (low < high) {
+      const int32_t middle = (low + high) / 2;
+      if (Cost(first_part(middle), summed_costs) < total_cost * share) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    position = low;
+  } else {
+    position = std::clamp(extent[0] + static_cast<int32_t>(share * (extent[1] - extent[0])),
+                          extent[0] + 1, extent[1] - 1);
+  }
+
+  Tile second = tile;
+  (split_columns ? second.columns : second.rows)[0] = position;
+  Split(first_part(position), first_count, summed_costs, tiles);
+  Split(second, tile_count - first_count, summed_costs, tiles);
+}
+
+double TileCostMap::Cost(const Tile& tile, const std::vector<double>& summed_costs) const {
+  const auto entry = [&](int32_t row, int32_t column) { return summed_costs[row * (width_ + 1) + column]; };
+  return entry(tile.rows[1], tile.columns[1]) - entry(tile.rows[0], tile.columns[1])
+      - entry(tile.rows[1], tile.columns[0]) + entry(tile.rows[0], tile.columns[0]);
+}
+}  // namespace rt
@@ -0,0 +1,143 @@
+#include "tile_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rt {
+namespace {
+// Tiles are not split below this many pixels, smaller tasks cost more to schedule than they balance.
+constexpr int32_t kMinimumSplitArea = 64;
+
+/**
+ * @return Position of the index along a Hilbert curve filling a grid of the given power of two size.
+ */
+glm::i32vec2 HilbertPosition(int32_t size, int32_t index) {
+  glm::i32vec2 position{0, 0};
+  for (int32_t scale = 1; scale < size; scale *= 2) {
+    const int32_t rx = 1 & (index / 2);
+    const int32_t ry = 1 & (index ^ rx);
+    if (ry == 0) {
+      if (rx == 1) position = glm::i32vec2{scale - 1} - position;
+      std::swap(position.x, position.y);
+    }
+    position += glm::i32vec2{scale * rx, scale * ry};
+    index /= 4;
+  }
+  return position;
+}
+
+std::pair<Tile, Tile> Split(const Tile& tile) {
+  Tile first = tile, second = tile;
+  if (tile.Width() >= tile.Height()) {
+    first.columns[1] = second.columns[0] = (tile.columns[0] + tile.columns[1]) / 2;
+  } else {
+    first.rows[1] = second.rows[0] = (tile.rows[0] + tile.rows[1]) / 2;
+  }
+  return {first, second};
+}
+}  // namespace
+
+std::vector<Tile> TileScheduler::ChunkTiles(const Tile& area, int32_t chunk_size) {
+  const int32_t width = area.Width(), height = area.Height();
+  chunk_size = std::max(chunk_size, 1);
+  const int32_t horizontal_chunks = (width + chunk_size - 1) / chunk_size;
+  const int32_t vertical_chunks = (height + chunk_size - 1) / chunk_size;
+  int32_t size = 1;
+  while (size < std::max(horizontal_chunks, vertical_chunks)) size *= 2;
+
+  std::vector<Tile> tiles;
+  tiles.reserve(static_cast<size_t>(horizontal_chunks) * vertical_chunks);
+  for (int32_t index = 0; index < size * size; ++index) {
+    const glm::i32vec2 chunk = HilbertPosition(size, index);
+    if (chunk.x >= horizontal_chunks || chunk.y >= vertical_chunks) continue;
+    const glm::i32vec2 rows{chunk.y * chunk_size, std::min((chunk.y + 1) * chunk_size, height)};
+    const glm::i32vec2 columns{chunk.x * chunk_size, std::min((chunk.x + 1) * chunk_size, width)};
+    tiles.push_back({area.rows[0] + rows, area.columns[0] + columns});
+  }
+  return tiles;
+}
+
+std::vector<Tile> TileScheduler::RowTiles(const Tile& area) {
+  std::vector<Tile> tiles;
+  tiles.reserve(std::max(area.Height(), 0));
+  for (int32_t row = area.rows[0]; row < area.rows[1]; ++row) {
+    tiles.push_back({{row, row + 1}, area.columns});
+  }
+  return tiles;
+}
+
+void TileScheduler::Run(BS::thread_pool& pool, const std::vector<Tile>& tiles, const TileFunction& function) {
+  const size_t worker_count = std::max<size_t>(pool.get_thread_count(), 1);
+  while (workers_.size() < worker_count) workers_.push_back(std::make_unique<Worker>());
+  for (size_t worker = 0; worker < worker_count; ++worker) {
+    workers_[worker]->tiles.assign(tiles.begin() + static_cast<std::ptrdiff_t>(worker * tiles.size() / worker_count),
+                                   tiles.begin()
+                                       + static_cast<std::ptrdiff_t>((worker + 1) * tiles.size() / worker_count));
+  }
+  pending_tiles_ = static_cast<int32_t>(tiles.size());
+  idle_workers_ = 0;
+  for (size_t worker = 0; worker < worker_count; ++worker) {
+    pool.push_task(&TileScheduler::Work, this, worker, std::cref(function));
+  }
+  pool.wait_for_tasks();
+}
+
+void TileScheduler::Work(size_t worker, const TileFunction& function) {
+  bool idle = false;
+  while (pending_tiles_ > 0) {
+    // Read before looking for a tile, so that a tile put in a deque after the search ends the wait.
+    const uint32_t generation = work_generation_;
+    Tile tile;
+    if (!Pop(worker, tile) && !Steal(worker, tile)) {
+      if (!idle) {
+        idle = true;
+        ++idle_workers_;
+      }
+      if (pending_tiles_ > 0) work_generation_.wait(generation);
+      continue;
+    }
+    if (idle) {
+      idle = false;
+      --idle_workers_;
+    }
+    for (int32_t splits = idle_workers_; splits > 0 && tile.Area() >= 2 * kMinimumSplitArea; --splits) {
+      auto [first, second] = Split(tile);
+      ++pending_tiles_;
+      {
+        std::lock_guard lock{workers_[worker]->mutex};
+        workers_[worker]->tiles.push_back(second);
+      }
+      ++work_generation_;
+      work_generation_.notify_all();
+      tile = first;
+    }
+    function(tile);
+    if (--pending_tiles_ == 0) {
+      ++work_generation_;
+      work_generation_.notify_all();
+    }
+  }
+  if (idle) --idle_workers_;
+}
+
+bool TileScheduler::Pop(size_t worker, Tile& tile) {
+  std::lock_guard lock{workers_[worker]->mutex};
+  if (workers_[worker]->tiles.empty()) return false;
+  tile = workers_[worker]->tiles.front();
+  workers_[worker]->tiles.pop_front();
+  return true;
+}
+
+bool TileScheduler::Steal(size_t thief, Tile& tile) {
+  const size_t worker_count = workers_.size();
+  for (size_t offset = 1; offset < worker_count; ++offset) {
+    Worker& victim = *workers_[(thief + offset) % worker_count];
+    std::lock_guard lock{victim.mutex};
+    if (victim.tiles.empty()) continue;
+    tile = victim.tiles.back();
+    victim.tiles.pop_back();
+    return true;
+  }
+  return false;
+}
+}  // namespace rt
@@ -63,6 +63,26 @@ glm::vec3 Transform::Centroid() const {
   return transform * glm::vec4{primitive_centroid, 1.0f};
 }
 
+float Transform::Area() const {
+  // Rotation and translation preserve the surface area.
+  return std::visit([](const auto& collidable) { return collidable.Area(); }, collidable_);
+}
+
+const material_t* Transform::GetMaterial() const {
+  return std::visit([](const auto& collidable) { return collidable.GetMaterial(); }, collidable_);
+}
+
+DirectionCone Transform::NormalBounds() const {
+  DirectionCone normals = std::visit([](const auto& collidable) { return collidable.NormalBounds(); }, collidable_);
+  normals.axis = glm::normalize(glm::vec3{TransformationMatrix() * glm::vec4{normals.axis, 0.0f}});
+  return normals;
+}
+
+void Transform::SetTransformation(float rotate_y, glm::vec3 translate) {
+  rotate_y_ = rotate_y;
+  translate_ = translate;
+}
+
 glm::mat4 Transform::TransformationMatrix() const {
   glm::mat4 rotation = glm::rotate(glm::mat4{1.0f}, glm::radians(rotate_y_), glm::vec3{0.0f, 1.0f, 0.0f});
   glm::mat4 translation = glm::translate(glm::mat4{1.0f}, translate_);
@@ -76,13 +96,21 @@ glm::mat4 Transform::InverseTransformationMatrix() const {
 }
 
 float Transform::PDFValue(const glm::vec3& origin, const glm::vec3& direction) const {
-  // TODO
-  return 0.0f;
+  // Rigid transformations preserve solid angles, so the density is that of the untransformed collidable.
+  const glm::mat4 inverse_transform = InverseTransformationMatrix();
+  const glm::vec3 transformed_origin = inverse_transform * glm::vec4{origin, 1.0f};
+  const glm::vec3 transformed_direction = inverse_transform * glm::vec4{direction, 0.0f};
+  return std::visit([&](const auto& collidable) {
+    return collidable.PDFValue(transformed_origin, transformed_direction);
+  }, collidable_);
 }
 
-glm::vec3 Transform::RandomTowards(const glm::vec3& origin) const {
-  // TODO
-  return {0.0f, 0.0f, 0.0f};
+glm::vec3 Transform::RandomTowards(const glm::vec3& origin, Sampler& sampler) const {
+  const glm::vec3 transformed_origin = InverseTransformationMatrix() * glm::vec4{origin, 1.0f};
+  const glm::vec3 direction = std::visit([&](const auto& collidable) {
+    return collidable.RandomTowards(transformed_origin, sampler);
+  }, collidable_);
+  return TransformationMatrix() * glm::vec4{direction, 0.0f};
 }
 
 }  // namespace rt
\ No newline at end of file
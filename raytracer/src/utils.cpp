@@ -1,7 +1,6 @@
 #include "utils.h"
 
 #include <algorithm>
-#include <cassert>
 #include <format>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -23,35 +22,43 @@ bool IsNearZero(const glm::vec3& vec) {
   return glm::all(glm::lessThan(glm::abs(vec), glm::vec3{kEpsilon}));
 }
 
+float Luminance(const glm::vec3& color) {
+  return glm::dot(color, glm::vec3{0.2126f, 0.7152f, 0.0722f});
+}
+
 namespace png {
 std::vector<uint8_t> Decode(const std::filesystem::path& path, int32_t& width, int32_t& height) {
+  constexpr int32_t kChannels = 3;
   int32_t channels;
-  const uint8_t* image_data = stbi_load(path.string().c_str(), &width, &height, &channels, 3);
+  uint8_t* image_data = stbi_load(path.string().c_str(), &width, &height, &channels, kChannels);
   if (image_data == nullptr) {
     throw std::runtime_error{std::format("Failed to decode PNG: {}.", path.string())};
   }
-  std::vector<uint8_t> buffer(image_data, image_data + width * height * channels);
+  std::vector<uint8_t> buffer(image_data, image_data + width * height * kChannels);
+  stbi_image_free(image_data);
   return buffer;
 }
 
-void Encode(const std::filesystem::path& path, const Image& image) {
+void Encode(const std::filesystem::path& path, const Framebuffer& framebuffer) {
   // Vertically flip the buffer data.
   std::vector<uint32_t> buffer;
-  buffer.resize(image.Width() * image.Height());
-  for (int32_t row = 0; row < image.Height(); ++row) {
-    for (int32_t column = 0; column < image.Width(); ++column) {
-      const int32_t originalIndex = row * image.Width() + column;
-      const int32_t flippedIndex = (image.Height() - row - 1) * image.Width() + column;
-      buffer[flippedIndex] = image.Buffer()[originalIndex];
+  buffer.resize(framebuffer.Width() * framebuffer.Height());
+  for (int32_t row = 0; row < framebuffer.Height(); ++row) {
+    for (int32_t column = 0; column < framebuffer.Width(); ++column) {
+      const int32_t originalIndex = row * framebuffer.Width() + column;
+      const int32_t flippedIndex = (framebuffer.Height() - row - 1) * framebuffer.Width() + column;
+      buffer[flippedIndex] = framebuffer.Front()[originalIndex];
     }
   }
   const int32_t result = stbi_write_png(path.string().c_str(),
-                                        image.Width(),
-                                        image.Height(),
+                                        framebuffer.Width(),
+                                        framebuffer.Height(),
                                         4,
                                         static_cast<void*>(buffer.data()),
-                                        image.Width() * 4);
-  assert(result != 0);
+                                        framebuffer.Width() * 4);
+  if (result == 0) {
+    throw std::runtime_error{std::format("Failed to encode PNG: {}.", path.string())};
+  }
 }
 
 }  // namespace rt::utils::png
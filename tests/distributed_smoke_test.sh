@@ -0,0 +1,29 @@
+#!/bin/sh
+# Renders on a coordinator with two workers, the first leaving while it holds a tile, and checks that the image matches
+# the one rendered in a single process.
+# Usage: distributed_smoke_test.sh <path to raytracing-cli>
+set -eu
+
+cli=$1
+directory=$(mktemp -d)
+coordinator_pid=""
+trap 'kill -9 $coordinator_pid 2>/dev/null || true; rm -rf "$directory"' EXIT
+
+options="--width 128 --height 128 --spp 16"
+"$cli" $options --threads 1 --output "$directory/local.png" > /dev/null
+
+"$cli" $options --coordinator "unix:$directory/raytracing.sock" --worker-timeout 30 \
+    --output "$directory/distributed.png" > /dev/null &
+coordinator_pid=$!
+# Alone until it leaves, the first worker renders a tile and is handed the next, which the second has to take over.
+"$cli" --worker "unix:$directory/raytracing.sock" --threads 1 --worker-tiles 1 > /dev/null
+"$cli" --worker "unix:$directory/raytracing.sock" --threads 1 > /dev/null
+
+status=0
+wait "$coordinator_pid" || status=$?
+coordinator_pid=""
+if [ "$status" -ne 0 ]; then
+  echo "The coordinator failed with status $status." >&2
+  exit 1
+fi
+cmp "$directory/local.png" "$directory/distributed.png"
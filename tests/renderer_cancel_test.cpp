@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "renderer.h"
+
+// Cancels a render during its first pass and checks that the pixels it did not sample keep the previous image.
+int main() {
+  rt::Renderer renderer{2};
+  rt::RendererSettings settings;
+  settings.width = 64;
+  settings.height = 64;
+  settings.chunk_size = 8;
+  settings.samples_per_pixel = 2;
+  settings.samples_per_pass = 2;
+  settings.adaptive_sampling = false;
+  renderer.Render(settings);
+  renderer.Wait();
+  renderer.Result().Flip();
+  const uint32_t* front = renderer.Result().Front();
+  const std::vector<uint32_t> previous(front, front + settings.width * settings.height);
+  if (std::ranges::count(previous, 0U) > 0) {
+    std::cerr << "The first render left pixels without a color.\n";
+    return EXIT_FAILURE;
+  }
+
+  // The first tile stops the render, the tiles which did not start yet take no sample.
+  settings.samples_per_pixel = 64;
+  settings.samples_per_pass = 64;
+  std::atomic<bool> cancelled = false;
+  rt::FramebufferSink cancel{
+      .on_tile = [&](const rt::Tile&, const uint32_t*) {
+        if (!cancelled.exchange(true)) renderer.Cancel();
+      },
+  };
+  renderer.Render(std::vector<rt::RenderJob>{{settings, {cancel}}});
+  renderer.Wait();
+  renderer.Result().Flip();
+
+  const std::vector<uint32_t>& sample_counts = renderer.SampleCounts();
+  size_t unsampled = 0;
+  for (size_t pixel = 0; pixel < previous.size(); ++pixel) {
+    if (sample_counts[pixel] > 0) continue;
+    ++unsampled;
+    if (front[pixel] != previous[pixel]) {
+      std::cerr << "Pixel " << pixel << " was not sampled but lost its previous color.\n";
+      return EXIT_FAILURE;
+    }
+  }
+  if (!renderer.Statistics().cancelled || unsampled == 0) {
+    std::cerr << "The render was not cancelled during its first pass.\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}